@@ -0,0 +1,172 @@
+#include "arenahashmap.h"
+
+#include <QHashFunctions>
+#include <algorithm>
+
+ArenaHashMap::ArenaHashMap(int initialBucketCount, float maxLoadFactor)
+    : maxLoadFactor_(maxLoadFactor) {
+    rehash(initialBucketCount);
+}
+
+quint32 ArenaHashMap::findNode(size_t hash, QStringView key) const {
+    for (quint32 i = heads_[static_cast<size_t>(index_.index(hash))]; i != kNil; i = nodes_[i].next) {
+        const Node &node = nodes_[i];
+        if (node.hash == hash && QAnyStringView::equal(StringArena::view(node.key), key)) {
+            return i;
+        }
+    }
+    return kNil;
+}
+
+bool ArenaHashMap::emplaceOrAssign(QStringView key, QStringView value, bool assignIfExists) {
+    const size_t hash = static_cast<size_t>(qHash(key));
+    const quint32 existing = findNode(hash, key);
+    if (existing != kNil) {
+        if (assignIfExists) {
+            Node &node = nodes_[existing];
+            deadBytes_ += StringArena::storedSize(node.value);
+            node.value = arena_.store(value);
+        }
+        return false;
+    }
+
+    maybeGrow();
+    Node fresh{arena_.store(key), arena_.store(value), hash, kNil};
+    quint32 slot = freeList_;
+    if (slot != kNil) {
+        freeList_ = nodes_[slot].next;
+        nodes_[slot] = fresh;
+    } else {
+        slot = static_cast<quint32>(nodes_.size());
+        nodes_.push_back(fresh);
+    }
+    quint32 &head = heads_[static_cast<size_t>(index_.index(hash))];
+    nodes_[slot].next = head;
+    head = slot;
+    ++numElements_;
+    return true;
+}
+
+bool ArenaHashMap::insert(QStringView key, QStringView value) {
+    return emplaceOrAssign(key, value, /*assignIfExists=*/false);
+}
+
+void ArenaHashMap::put(QStringView key, QStringView value) {
+    (void)emplaceOrAssign(key, value, /*assignIfExists=*/true);
+}
+
+std::optional<QAnyStringView> ArenaHashMap::find(QStringView key) const {
+    const quint32 i = findNode(static_cast<size_t>(qHash(key)), key);
+    if (i == kNil) return std::nullopt;
+    return StringArena::view(nodes_[i].value);
+}
+
+std::optional<QString> ArenaHashMap::get(QStringView key) const {
+    const std::optional<QAnyStringView> value = find(key);
+    if (!value) return std::nullopt;
+    return value->toString();
+}
+
+bool ArenaHashMap::contains(QStringView key) const {
+    return findNode(static_cast<size_t>(qHash(key)), key) != kNil;
+}
+
+bool ArenaHashMap::erase(QStringView key) {
+    const size_t hash = static_cast<size_t>(qHash(key));
+    quint32 *link = &heads_[static_cast<size_t>(index_.index(hash))];
+    while (*link != kNil) {
+        const quint32 i = *link;
+        Node &node = nodes_[i];
+        if (node.hash == hash && QAnyStringView::equal(StringArena::view(node.key), key)) {
+            *link = node.next;
+            deadBytes_ += StringArena::storedSize(node.key) + StringArena::storedSize(node.value);
+            node = Node{};
+            node.next = freeList_;
+            freeList_ = i;
+            --numElements_;
+            return true;
+        }
+        link = &node.next;
+    }
+    return false;
+}
+
+void ArenaHashMap::clear() {
+    nodes_.clear();
+    std::fill(heads_.begin(), heads_.end(), kNil);
+    freeList_ = kNil;
+    numElements_ = 0;
+    arena_.clear();
+    deadBytes_ = 0;
+}
+
+int ArenaHashMap::size() const {
+    return numElements_;
+}
+
+int ArenaHashMap::bucketCount() const {
+    return static_cast<int>(heads_.size());
+}
+
+float ArenaHashMap::loadFactor() const {
+    if (heads_.empty()) return 0.0f;
+    return static_cast<float>(numElements_) / static_cast<float>(heads_.size());
+}
+
+void ArenaHashMap::maybeGrow() {
+    const float projected = (static_cast<float>(numElements_) + 1.0f) / static_cast<float>(heads_.size());
+    if (projected > maxLoadFactor_) {
+        rehash(bucketCount() * 2);
+    }
+}
+
+void ArenaHashMap::rehash(int newBucketCount) {
+    const int count = PowerOfTwoIndex::roundBucketCount(std::max(1, newBucketCount));
+    heads_.assign(static_cast<size_t>(count), kNil);
+    index_.setBucketCount(count);
+    // Free-list slots have a null key; everything else is relinked using
+    // its cached hash.
+    for (quint32 i = 0; i < static_cast<quint32>(nodes_.size()); ++i) {
+        Node &node = nodes_[i];
+        if (!node.key) continue;
+        quint32 &head = heads_[static_cast<size_t>(index_.index(node.hash))];
+        node.next = head;
+        head = i;
+    }
+}
+
+void ArenaHashMap::reserve(int expectedElements) {
+    if (expectedElements <= 0) return;
+    const float desiredLoad = std::min(0.6f, maxLoadFactor_); // target below max for headroom
+    const int requiredBuckets = PowerOfTwoIndex::roundBucketCount(
+        std::max(1, static_cast<int>(expectedElements / desiredLoad)));
+    if (requiredBuckets > bucketCount()) {
+        rehash(requiredBuckets);
+    }
+    nodes_.reserve(static_cast<size_t>(expectedElements));
+}
+
+void ArenaHashMap::compact() {
+    // Live entries are copied byte for byte and the node array is packed,
+    // which also empties the free list.
+    StringArena fresh;
+    std::vector<Node> packed;
+    packed.reserve(static_cast<size_t>(numElements_));
+    for (const Node &node : nodes_) {
+        if (!node.key) continue;
+        packed.push_back(Node{fresh.storeCopy(node.key), fresh.storeCopy(node.value), node.hash, kNil});
+    }
+    nodes_.swap(packed);
+    arena_ = std::move(fresh);
+    freeList_ = kNil;
+    deadBytes_ = 0;
+    rehash(bucketCount());
+}
+
+qsizetype ArenaHashMap::arenaBytes() const {
+    return arena_.bytesUsed();
+}
+
+qsizetype ArenaHashMap::deadBytes() const {
+    return deadBytes_;
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <QAnyStringView>
+#include <QString>
+#include <QStringView>
+#include "hashindex.h"
+#include "stringarena.h"
+#include <optional>
+#include <vector>
+
+// Compact-storage variant of the chained HashMap. Keys and values are
+// copied into a StringArena (Latin-1 or UTF-8 with a length prefix) and
+// nodes hold only the two arena pointers, the cached hash and the next
+// index, so millions of short ASCII entries stay close to their payload
+// size. Lookups compare the probe against the stored bytes through
+// QAnyStringView without building a QString.
+//
+// The arena never frees individual strings: erase() and overwriting put()
+// leave dead bytes behind, and compact() rebuilds the arena from the live
+// entries when deadBytes() grows too large. No step trace is recorded.
+class ArenaHashMap {
+public:
+    explicit ArenaHashMap(int initialBucketCount = 16, float maxLoadFactor = 0.75f);
+
+    bool insert(QStringView key, QStringView value);
+    void put(QStringView key, QStringView value);
+
+    std::optional<QString> get(QStringView key) const;
+
+    // View into the arena; valid until the entry is overwritten or erased,
+    // or the map is compacted or cleared.
+    std::optional<QAnyStringView> find(QStringView key) const;
+
+    bool erase(QStringView key);
+    bool contains(QStringView key) const;
+    void clear();
+
+    int size() const;
+    int bucketCount() const;
+    float loadFactor() const;
+
+    void rehash(int newBucketCount);
+    void reserve(int expectedElements);
+
+    // Copies the live strings into a fresh arena and drops the old one.
+    void compact();
+
+    qsizetype arenaBytes() const;  // bytes handed out by the arena, live and dead
+    qsizetype deadBytes() const;   // bytes of erased or overwritten strings
+
+private:
+    static constexpr quint32 kNil = 0xFFFFFFFFu;
+
+    struct Node {
+        const char *key = nullptr;
+        const char *value = nullptr;
+        size_t hash = 0;
+        quint32 next = kNil;
+    };
+
+    std::vector<Node> nodes_;
+    std::vector<quint32> heads_;
+    PowerOfTwoIndex index_;
+    quint32 freeList_ = kNil;
+    int numElements_ = 0;
+    float maxLoadFactor_ = 0.75f;
+
+    StringArena arena_;
+    qsizetype deadBytes_ = 0;
+
+    quint32 findNode(size_t hash, QStringView key) const;
+    bool emplaceOrAssign(QStringView key, QStringView value, bool assignIfExists);
+    void maybeGrow();
+};
@@ -0,0 +1,332 @@
+#include <QHash>
+#include <QString>
+#include <QStringView>
+#include "concurrenthashmap.h"
+#include "hashmap.h"
+#include "readoptimizedhashmap.h"
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cstdio>
+#include <optional>
+#include <random>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Google Benchmark suite for the HashMap core. Every single-threaded case
+// takes (element count, key length) arguments; the JSON report used to
+// track regressions is written by the bench_json target, or by passing
+// --benchmark_out=<file> --benchmark_out_format=json directly.
+
+namespace {
+
+// Present keys start with 'k' and absent ones with 'm', followed by a
+// base-36 counter, so every key is unique and no miss can hit. Random
+// letters pad each key to the requested length.
+std::vector<QString> makeKeys(int count, int length, QChar prefix, quint32 seed) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> letter('a', 'z');
+    std::vector<QString> keys;
+    keys.reserve(static_cast<size_t>(count));
+    for (int i = 0; i < count; ++i) {
+        QString key = prefix + QString::number(i, 36);
+        key.reserve(length);
+        while (key.size() < length) key.append(QChar(letter(rng)));
+        keys.push_back(std::move(key));
+    }
+    return keys;
+}
+
+// Lookups visit keys in a random order so consecutive probes do not walk
+// neighbouring nodes.
+std::vector<QString> shuffled(std::vector<QString> keys) {
+    std::shuffle(keys.begin(), keys.end(), std::mt19937(7));
+    return keys;
+}
+
+// Common operation surface over the maps under test. Lookups return the
+// value by copy everywhere, matching BasicHashMap::get().
+template <typename Map>
+struct ChainedAdapter {
+    Map map;
+    bool insert(const QString &key, const QString &value) { return map.insert(key, value); }
+    void put(const QString &key, const QString &value) { map.put(key, value); }
+    std::optional<QString> get(QStringView key) { return map.get(key); }
+    bool erase(QStringView key) { return map.erase(key); }
+    // rehash() appends to the trace of the last operation instead of
+    // starting a new one, so a traced map would accumulate steps forever.
+    void rehash(int buckets) {
+        map.clearSteps();
+        map.rehash(buckets);
+    }
+    void reserve(int elements) { map.reserve(elements); }
+    int bucketCount() const { return map.bucketCount(); }
+};
+
+struct StdAdapter {
+    std::unordered_map<QString, QString> map;
+    bool insert(const QString &key, const QString &value) { return map.emplace(key, value).second; }
+    void put(const QString &key, const QString &value) { map.insert_or_assign(key, value); }
+    std::optional<QString> get(QStringView key) {
+        // std::unordered_map has no heterogeneous lookup in C++17.
+        const auto it = map.find(key.toString());
+        if (it == map.end()) return std::nullopt;
+        return it->second;
+    }
+    bool erase(QStringView key) { return map.erase(key.toString()) != 0; }
+    void rehash(int buckets) { map.rehash(static_cast<size_t>(buckets)); }
+    void reserve(int elements) { map.reserve(static_cast<size_t>(elements)); }
+    int bucketCount() const { return static_cast<int>(map.bucket_count()); }
+};
+
+struct QHashAdapter {
+    QHash<QString, QString> map;
+    bool insert(const QString &key, const QString &value) {
+        if (map.contains(key)) return false;
+        map.insert(key, value);
+        return true;
+    }
+    void put(const QString &key, const QString &value) { map.insert(key, value); }
+    std::optional<QString> get(QStringView key) {
+        const auto it = map.constFind(key.toString());
+        if (it == map.constEnd()) return std::nullopt;
+        return it.value();
+    }
+    bool erase(QStringView key) { return map.remove(key.toString()); }
+    // QHash cannot be told a bucket count; reserving that many elements is
+    // the closest equivalent. reserve() never shrinks and returns early
+    // when the capacity already suffices, so a smaller request squeezes
+    // first: both rehashes are timed together, as a real resize would be.
+    void rehash(int buckets) {
+        if (buckets < map.capacity()) map.squeeze();
+        map.reserve(buckets);
+    }
+    void reserve(int elements) { map.reserve(elements); }
+    int bucketCount() const { return static_cast<int>(map.capacity()); }
+};
+
+template <typename Adapter>
+void fill(Adapter &adapter, const std::vector<QString> &keys) {
+    for (const QString &key : keys) adapter.insert(key, key);
+}
+
+void setCounts(benchmark::State &state, int64_t perIteration) {
+    state.SetItemsProcessed(state.iterations() * perIteration);
+}
+
+template <typename Adapter>
+void BM_Insert(benchmark::State &state) {
+    const int count = static_cast<int>(state.range(0));
+    const std::vector<QString> keys = makeKeys(count, static_cast<int>(state.range(1)), 'k', 1);
+    for (auto _ : state) {
+        Adapter adapter;
+        fill(adapter, keys);
+        benchmark::DoNotOptimize(adapter.bucketCount());
+        state.PauseTiming(); // destruction is not part of the insert cost
+        adapter = Adapter();
+        state.ResumeTiming();
+    }
+    setCounts(state, count);
+}
+
+template <typename Adapter>
+void BM_InsertReserved(benchmark::State &state) {
+    const int count = static_cast<int>(state.range(0));
+    const std::vector<QString> keys = makeKeys(count, static_cast<int>(state.range(1)), 'k', 1);
+    for (auto _ : state) {
+        Adapter adapter;
+        adapter.reserve(count);
+        fill(adapter, keys);
+        benchmark::DoNotOptimize(adapter.bucketCount());
+        state.PauseTiming();
+        adapter = Adapter();
+        state.ResumeTiming();
+    }
+    setCounts(state, count);
+}
+
+// put() over keys that are all present: the assigning update path.
+template <typename Adapter>
+void BM_PutExisting(benchmark::State &state) {
+    const int count = static_cast<int>(state.range(0));
+    const std::vector<QString> keys = makeKeys(count, static_cast<int>(state.range(1)), 'k', 1);
+    const std::vector<QString> order = shuffled(keys);
+    const QString value = QStringLiteral("updated");
+    Adapter adapter;
+    fill(adapter, keys);
+    size_t i = 0;
+    for (auto _ : state) {
+        adapter.put(order[i], value);
+        if (++i == order.size()) i = 0;
+    }
+    setCounts(state, 1);
+}
+
+template <typename Adapter>
+void BM_GetHit(benchmark::State &state) {
+    const int count = static_cast<int>(state.range(0));
+    const std::vector<QString> keys = makeKeys(count, static_cast<int>(state.range(1)), 'k', 1);
+    const std::vector<QString> order = shuffled(keys);
+    Adapter adapter;
+    fill(adapter, keys);
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(adapter.get(order[i]));
+        if (++i == order.size()) i = 0;
+    }
+    setCounts(state, 1);
+}
+
+template <typename Adapter>
+void BM_GetMiss(benchmark::State &state) {
+    const int count = static_cast<int>(state.range(0));
+    const int length = static_cast<int>(state.range(1));
+    const std::vector<QString> keys = makeKeys(count, length, 'k', 1);
+    const std::vector<QString> misses = makeKeys(count, length, 'm', 2);
+    Adapter adapter;
+    fill(adapter, keys);
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(adapter.get(misses[i]));
+        if (++i == misses.size()) i = 0;
+    }
+    setCounts(state, 1);
+}
+
+template <typename Adapter>
+void BM_Erase(benchmark::State &state) {
+    const int count = static_cast<int>(state.range(0));
+    const std::vector<QString> keys = makeKeys(count, static_cast<int>(state.range(1)), 'k', 1);
+    const std::vector<QString> order = shuffled(keys);
+    for (auto _ : state) {
+        state.PauseTiming();
+        Adapter adapter;
+        adapter.reserve(count);
+        fill(adapter, keys);
+        state.ResumeTiming();
+        for (const QString &key : order) benchmark::DoNotOptimize(adapter.erase(key));
+        state.PauseTiming();
+        adapter = Adapter();
+        state.ResumeTiming();
+    }
+    setCounts(state, count);
+}
+
+// Alternates between two bucket counts so every iteration moves all keys.
+template <typename Adapter>
+void BM_Rehash(benchmark::State &state) {
+    const int count = static_cast<int>(state.range(0));
+    const std::vector<QString> keys = makeKeys(count, static_cast<int>(state.range(1)), 'k', 1);
+    Adapter adapter;
+    fill(adapter, keys);
+    const int small = std::max(16, count);
+    bool grow = true;
+    for (auto _ : state) {
+        adapter.rehash(grow ? small * 2 : small);
+        grow = !grow;
+    }
+    setCounts(state, count);
+}
+
+// Sizes 1e3..1e7 at key lengths 8, 32 and 128 UTF-16 code units. The
+// largest key sets are skipped past 1e8 code units, which would need
+// several gigabytes before the maps hold anything.
+void sizesAndKeyLengths(benchmark::internal::Benchmark *b) {
+    for (int64_t length : {8, 32, 128}) {
+        for (int64_t count = 1000; count <= 10000000; count *= 10) {
+            if (count * length > 100000000) continue;
+            b->Args({count, length});
+        }
+    }
+    b->ArgNames({"n", "keylen"});
+}
+
+// Rebuilding the map for every iteration is slow at the top sizes, so
+// those cases stop at 1e6.
+void buildPerIteration(benchmark::internal::Benchmark *b) {
+    for (int64_t length : {8, 32, 128}) {
+        for (int64_t count = 1000; count <= 1000000; count *= 10) b->Args({count, length});
+    }
+    b->ArgNames({"n", "keylen"});
+    b->Unit(benchmark::kMillisecond);
+}
+
+using Traced = ChainedAdapter<HashMap>;
+using Untraced = ChainedAdapter<FastHashMap>;
+
+#define DSV_HASHMAP_BENCHMARKS(Adapter)                                              \
+    BENCHMARK_TEMPLATE(BM_Insert, Adapter)->Apply(buildPerIteration);                \
+    BENCHMARK_TEMPLATE(BM_InsertReserved, Adapter)->Apply(buildPerIteration);        \
+    BENCHMARK_TEMPLATE(BM_PutExisting, Adapter)->Apply(sizesAndKeyLengths);          \
+    BENCHMARK_TEMPLATE(BM_GetHit, Adapter)->Apply(sizesAndKeyLengths);               \
+    BENCHMARK_TEMPLATE(BM_GetMiss, Adapter)->Apply(sizesAndKeyLengths);              \
+    BENCHMARK_TEMPLATE(BM_Erase, Adapter)->Apply(buildPerIteration);                 \
+    BENCHMARK_TEMPLATE(BM_Rehash, Adapter)->Apply(buildPerIteration);
+
+DSV_HASHMAP_BENCHMARKS(Traced)
+DSV_HASHMAP_BENCHMARKS(Untraced)
+DSV_HASHMAP_BENCHMARKS(StdAdapter)
+DSV_HASHMAP_BENCHMARKS(QHashAdapter)
+
+// Index and hash policies on the untraced map, lookups only.
+BENCHMARK_TEMPLATE(BM_GetHit, ChainedAdapter<BasicHashMap<NoTrace, PowerOfTwoIndex>>)->Apply(sizesAndKeyLengths);
+BENCHMARK_TEMPLATE(BM_GetHit, ChainedAdapter<BasicHashMap<NoTrace, PrimeIndex>>)->Apply(sizesAndKeyLengths);
+BENCHMARK_TEMPLATE(BM_GetHit, ChainedAdapter<BasicHashMap<NoTrace, FastRangeIndex>>)->Apply(sizesAndKeyLengths);
+BENCHMARK_TEMPLATE(BM_GetHit, ChainedAdapter<BasicHashMap<NoTrace, ModuloIndex, WyHash>>)->Apply(sizesAndKeyLengths);
+BENCHMARK_TEMPLATE(BM_GetHit, ChainedAdapter<BasicHashMap<NoTrace, ModuloIndex, XxHash3>>)->Apply(sizesAndKeyLengths);
+BENCHMARK_TEMPLATE(BM_GetHit, ChainedAdapter<BasicHashMap<NoTrace, ModuloIndex, Fnv1aHash>>)->Apply(sizesAndKeyLengths);
+
+// Read scaling across threads. Every thread shares one map of 1e6 keys,
+// built on first use; the function-local static makes that thread-safe.
+constexpr int kSharedKeyCount = 1000000;
+
+template <typename Map>
+struct SharedReadFixture {
+    SharedReadFixture() : keys(shuffled(makeKeys(kSharedKeyCount, 16, 'k', 1))) {
+        for (const QString &key : keys) map.insert(key, key);
+    }
+    std::vector<QString> keys;
+    Map map;
+};
+
+template <typename Map>
+SharedReadFixture<Map> &sharedReadFixture() {
+    static SharedReadFixture<Map> fixture;
+    return fixture;
+}
+
+template <typename Map>
+void BM_ConcurrentGet(benchmark::State &state) {
+    SharedReadFixture<Map> &fixture = sharedReadFixture<Map>();
+    // Threads start at different offsets so they do not probe in lockstep.
+    size_t i = static_cast<size_t>(state.thread_index()) * 7919 % fixture.keys.size();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(fixture.map.get(fixture.keys[i]));
+        if (++i == fixture.keys.size()) i = 0;
+    }
+    setCounts(state, 1);
+}
+
+int maxBenchThreads() {
+    return static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+}
+
+BENCHMARK_TEMPLATE(BM_ConcurrentGet, ReadOptimizedHashMap)->ThreadRange(1, maxBenchThreads())->UseRealTime();
+BENCHMARK_TEMPLATE(BM_ConcurrentGet, ConcurrentHashMap)->ThreadRange(1, maxBenchThreads())->UseRealTime();
+
+} // namespace
+
+int main(int argc, char **argv) {
+    // Numbers from a hash function that no longer matches its reference are
+    // not worth recording.
+    QString error;
+    if (!verifyHashFunctions(&error)) {
+        std::fprintf(stderr, "Hash self-test failed: %s\n", qPrintable(error));
+        return 1;
+    }
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,63 @@
+#include "bloomfilter.h"
+
+#include <algorithm>
+
+namespace {
+
+// Salts from the Parquet split-block filter specification.
+constexpr quint32 kSalts[8] = {
+    0x47b6137bu, 0x44974d91u, 0x8824ad5bu, 0xa2b7289du,
+    0x705495c7u, 0x2df1424bu, 0x9efc4947u, 0x5c6bfb31u,
+};
+
+// Hash policies differ in quality (FNV-1a in particular mixes its high
+// bits poorly), so the filter remixes before splitting the hash.
+quint64 remix(quint64 h) {
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+quint32 bitInWord(quint64 h, int word) {
+    return 1u << ((static_cast<quint32>(h) * kSalts[word]) >> 27);
+}
+
+} // namespace
+
+void BlockedBloomFilter::reset(qsizetype expectedKeys, int bitsPerKey) {
+    const qsizetype bits = std::max<qsizetype>(1, expectedKeys) * std::max(1, bitsPerKey);
+    const qsizetype blockCount = std::max<qsizetype>(1, (bits + 255) / 256);
+    blocks_.assign(static_cast<size_t>(blockCount), Block{});
+    blocks_.shrink_to_fit();
+}
+
+void BlockedBloomFilter::clear() {
+    std::fill(blocks_.begin(), blocks_.end(), Block{});
+}
+
+size_t BlockedBloomFilter::blockIndex(quint64 mixedHash) const {
+    // Multiply-shift maps the upper 32 bits onto [0, block count).
+    return static_cast<size_t>(((mixedHash >> 32) * static_cast<quint64>(blocks_.size())) >> 32);
+}
+
+void BlockedBloomFilter::insert(quint64 hash) {
+    if (blocks_.empty()) return;
+    const quint64 h = remix(hash);
+    Block &block = blocks_[blockIndex(h)];
+    for (int word = 0; word < 8; ++word) {
+        block.words[word] |= bitInWord(h, word);
+    }
+}
+
+bool BlockedBloomFilter::mayContain(quint64 hash) const {
+    if (blocks_.empty()) return true;
+    const quint64 h = remix(hash);
+    const Block &block = blocks_[blockIndex(h)];
+    for (int word = 0; word < 8; ++word) {
+        if ((block.words[word] & bitInWord(h, word)) == 0) return false;
+    }
+    return true;
+}
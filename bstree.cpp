@@ -0,0 +1,148 @@
+#include "bstree.h"
+
+#include <algorithm>
+
+TreeStep &TreeStepTrace::record(TreeStepOp op, int value, int other, int depth) {
+    steps_.push_back(TreeStep{op, value, other, depth});
+    return steps_.back();
+}
+
+QString TreeStepTrace::format(int i) const {
+    const TreeStep &s = at(i);
+    switch (s.op) {
+    case TreeStepOp::Compare:
+        return s.depth == 0 ? QStringLiteral("Comparing %1 with root %2").arg(s.value).arg(s.other)
+                            : QStringLiteral("Comparing %1 with %2").arg(s.value).arg(s.other);
+    case TreeStepOp::InsertRoot:
+        return QStringLiteral("Inserted %1 as root node").arg(s.value);
+    case TreeStepOp::InsertLeft:
+        return QStringLiteral("Inserted %1 as left child of %2").arg(s.value).arg(s.other);
+    case TreeStepOp::InsertRight:
+        return QStringLiteral("Inserted %1 as right child of %2").arg(s.value).arg(s.other);
+    case TreeStepOp::Duplicate:
+        return QStringLiteral("Value %1 already exists in tree!").arg(s.value);
+    case TreeStepOp::Cleared:
+        return QStringLiteral("Tree cleared");
+    }
+    return QString();
+}
+
+template <typename TracePolicy>
+TreeNodeId BasicBinarySearchTree<TracePolicy>::allocateNode(int value) {
+    nodes_.push_back(TreeNode{value, kNoTreeNode, kNoTreeNode});
+    return static_cast<TreeNodeId>(nodes_.size() - 1);
+}
+
+template <typename TracePolicy>
+bool BasicBinarySearchTree<TracePolicy>::insert(int value) {
+    clearSteps();
+    if (nodes_.empty()) {
+        allocateNode(value);
+        trace([&](TreeStepTrace &t) { t.record(TreeStepOp::InsertRoot, value); });
+        return true;
+    }
+
+    TreeNodeId parent = 0;
+    for (int depth = 0;; ++depth) {
+        // Copy the key: allocateNode() below may move the pool.
+        const int parentValue = nodes_[parent].value;
+        trace([&](TreeStepTrace &t) { t.record(TreeStepOp::Compare, value, parentValue, depth); });
+        if (value == parentValue) {
+            trace([&](TreeStepTrace &t) { t.record(TreeStepOp::Duplicate, value); });
+            return false;
+        }
+        const bool goLeft = value < parentValue;
+        const TreeNodeId child = goLeft ? nodes_[parent].left : nodes_[parent].right;
+        if (child == kNoTreeNode) {
+            const TreeNodeId id = allocateNode(value);
+            TreeNode &linked = nodes_[parent];
+            (goLeft ? linked.left : linked.right) = id;
+            const TreeStepOp op = goLeft ? TreeStepOp::InsertLeft : TreeStepOp::InsertRight;
+            trace([&](TreeStepTrace &t) { t.record(op, value, parentValue); });
+            return true;
+        }
+        parent = child;
+    }
+}
+
+template <typename TracePolicy>
+TreeNodeId BasicBinarySearchTree<TracePolicy>::find(int value) const {
+    TreeNodeId id = root();
+    while (id != kNoTreeNode) {
+        const TreeNode &node = nodes_[id];
+        if (node.value == value) break;
+        id = value < node.value ? node.left : node.right;
+    }
+    return id;
+}
+
+template <typename TracePolicy>
+bool BasicBinarySearchTree<TracePolicy>::contains(int value) const {
+    return find(value) != kNoTreeNode;
+}
+
+template <typename TracePolicy>
+void BasicBinarySearchTree<TracePolicy>::clear(bool releaseStorage) {
+    clearSteps();
+    // TreeNode is trivially destructible, so this only resets the pool's end.
+    nodes_.clear();
+    if (releaseStorage) nodes_.shrink_to_fit();
+    trace([&](TreeStepTrace &t) { t.record(TreeStepOp::Cleared, 0); });
+}
+
+template <typename TracePolicy>
+void BasicBinarySearchTree<TracePolicy>::reserve(int count) {
+    if (count > 0) nodes_.reserve(static_cast<size_t>(count));
+}
+
+template <typename TracePolicy>
+TreeNodeId BasicBinarySearchTree<TracePolicy>::root() const {
+    return nodes_.empty() ? kNoTreeNode : 0;
+}
+
+template <typename TracePolicy>
+int BasicBinarySearchTree<TracePolicy>::nodeCount() const {
+    return static_cast<int>(nodes_.size());
+}
+
+template <typename TracePolicy>
+int BasicBinarySearchTree<TracePolicy>::size() const {
+    // Nothing is ever erased, so every pool slot holds a live node.
+    return static_cast<int>(nodes_.size());
+}
+
+template <typename TracePolicy>
+bool BasicBinarySearchTree<TracePolicy>::isEmpty() const {
+    return nodes_.empty();
+}
+
+template <typename TracePolicy>
+int BasicBinarySearchTree<TracePolicy>::height() const {
+    // Children always come after their parent in the pool, so one forward
+    // pass computes every node's depth without a stack or queue.
+    if (nodes_.empty()) return 0;
+    std::vector<int> depth(nodes_.size(), 0);
+    int deepest = 0;
+    depth[0] = 1;
+    for (size_t i = 0; i < nodes_.size(); ++i) {
+        const TreeNode &node = nodes_[i];
+        const int childDepth = depth[i] + 1;
+        if (node.left != kNoTreeNode) depth[node.left] = childDepth;
+        if (node.right != kNoTreeNode) depth[node.right] = childDepth;
+        deepest = std::max(deepest, depth[i]);
+    }
+    return deepest;
+}
+
+template <typename TracePolicy>
+const TreeStepTrace &BasicBinarySearchTree<TracePolicy>::lastSteps() const {
+    return steps_;
+}
+
+template <typename TracePolicy>
+void BasicBinarySearchTree<TracePolicy>::clearSteps() {
+    steps_.clear();
+}
+
+template class BasicBinarySearchTree<StepTrace>;
+template class BasicBinarySearchTree<NoTrace>;
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <QString>
+#include <QtGlobal>
+#include "hashstep.h"
+#include <vector>
+
+// Kinds of steps a tree insertion can record.
+enum class TreeStepOp : quint8 {
+    Compare,     // value against the node holding other, depth levels down
+    InsertRoot,  // value
+    InsertLeft,  // value as the left child of other
+    InsertRight, // value as the right child of other
+    Duplicate,   // value is already in the tree
+    Cleared,
+};
+
+struct TreeStep {
+    TreeStepOp op = TreeStepOp::Compare;
+    int value = 0;
+    int other = 0;
+    int depth = 0;
+};
+
+// Steps of the last tree operation; text is produced on demand by format().
+class TreeStepTrace {
+public:
+    void clear() { steps_.clear(); }
+    TreeStep &record(TreeStepOp op, int value, int other = 0, int depth = 0);
+
+    int size() const { return static_cast<int>(steps_.size()); }
+    bool isEmpty() const { return steps_.empty(); }
+    const TreeStep &at(int i) const { return steps_[static_cast<size_t>(i)]; }
+    QString format(int i) const;
+
+private:
+    std::vector<TreeStep> steps_;
+};
+
+// Index of a node in a tree's node pool; kNoTreeNode stands for an absent
+// child (or the root of an empty tree).
+using TreeNodeId = quint32;
+constexpr TreeNodeId kNoTreeNode = 0xFFFFFFFFu;
+
+// Only what a search touches: the key and two 32-bit child indices, so a
+// node is 12 bytes and several share a cache line.
+struct TreeNode {
+    int value = 0;
+    TreeNodeId left = kNoTreeNode;
+    TreeNodeId right = kNoTreeNode;
+};
+
+// Binary search tree over distinct ints. Nodes live in one contiguous pool
+// in insertion order and link to each other by index; ids stay valid until
+// clear(). Holds no layout or highlight state: views keep their own in
+// arrays indexed by TreeNodeId. Tracing follows the hash map engines (see
+// hashstep.h): StepTrace records a TreeStepTrace for every insertion,
+// NoTrace compiles the recording away.
+template <typename TracePolicy>
+class BasicBinarySearchTree {
+public:
+    BasicBinarySearchTree() = default;
+    Q_DISABLE_COPY_MOVE(BasicBinarySearchTree)
+
+    // Returns false, leaving the tree unchanged, if value is already present.
+    bool insert(int value);
+    bool contains(int value) const;
+    // kNoTreeNode if value is absent.
+    TreeNodeId find(int value) const;
+
+    // Drops every node at once without walking the tree. The pool keeps its
+    // capacity for the next tree unless releaseStorage is set.
+    void clear(bool releaseStorage = false);
+    // Presizes the pool so count nodes can be inserted without reallocating.
+    void reserve(int count);
+
+    TreeNodeId root() const;
+    const TreeNode &node(TreeNodeId id) const { return nodes_[id]; }
+    // One past the largest id in use, for sizing per-node view arrays.
+    int nodeCount() const;
+    int size() const;
+    bool isEmpty() const;
+    int height() const;
+
+    // Always empty when tracing is disabled.
+    const TreeStepTrace &lastSteps() const;
+    void clearSteps();
+
+private:
+    template <typename Fill>
+    void trace(Fill &&fill) {
+        if constexpr (TracePolicy::enabled) fill(steps_);
+    }
+
+    TreeNodeId allocateNode(int value);
+
+    std::vector<TreeNode> nodes_; // node pool, root first
+    TreeStepTrace steps_;
+};
+
+// Tracing build used by the visualizer.
+using BinarySearchTree = BasicBinarySearchTree<StepTrace>;
+
+// Trace-free build for headless workloads.
+using FastBinarySearchTree = BasicBinarySearchTree<NoTrace>;
+
+extern template class BasicBinarySearchTree<StepTrace>;
+extern template class BasicBinarySearchTree<NoTrace>;
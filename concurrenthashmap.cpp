@@ -0,0 +1,148 @@
+#include "concurrenthashmap.h"
+
+#include <QElapsedTimer>
+#include <QThread>
+#include <algorithm>
+
+template <typename TracePolicy>
+BasicConcurrentHashMap<TracePolicy>::ShardLocker::ShardLocker(Shard &shard)
+    : shard_(shard) {
+    if (!shard_.mutex.tryLock()) {
+        QElapsedTimer timer;
+        timer.start();
+        shard_.mutex.lock();
+        const quint64 waited = static_cast<quint64>(timer.nsecsElapsed());
+        shard_.contended.store(shard_.contended.load(std::memory_order_relaxed) + 1,
+                               std::memory_order_relaxed);
+        shard_.waitNanos.store(shard_.waitNanos.load(std::memory_order_relaxed) + waited,
+                               std::memory_order_relaxed);
+    }
+    // Only the lock holder writes the counters, so a plain load/store pair
+    // avoids a locked read-modify-write on every operation.
+    shard_.acquisitions.store(shard_.acquisitions.load(std::memory_order_relaxed) + 1,
+                              std::memory_order_relaxed);
+}
+
+template <typename TracePolicy>
+BasicConcurrentHashMap<TracePolicy>::ShardLocker::~ShardLocker() {
+    shard_.mutex.unlock();
+}
+
+template <typename TracePolicy>
+BasicConcurrentHashMap<TracePolicy>::BasicConcurrentHashMap(int shardCount, int expectedElements) {
+    if (shardCount <= 0) shardCount = 4 * std::max(1, QThread::idealThreadCount());
+    shardCount_ = shardCount;
+    shards_.reset(new Shard[static_cast<size_t>(shardCount_)]);
+    if (expectedElements > 0) {
+        const int perShard = (expectedElements + shardCount_ - 1) / shardCount_;
+        for (int i = 0; i < shardCount_; ++i) {
+            shards_[i].map.reserve(perShard);
+        }
+    }
+}
+
+template <typename TracePolicy>
+int BasicConcurrentHashMap<TracePolicy>::shardIndexOf(QStringView key) const {
+    return shardIndexOfHash(QtHash::hash(key));
+}
+
+template <typename TracePolicy>
+int BasicConcurrentHashMap<TracePolicy>::shardIndexOfHash(size_t hash) const {
+    // Mix so that the high bits depend on the whole hash, then scale the
+    // result onto [0, shardCount_) without a division.
+    const quint64 mixed = static_cast<quint64>(hash) * 0x9E3779B97F4A7C15ull;
+    return static_cast<int>(hashindex::mulHigh64(mixed, static_cast<quint64>(shardCount_)));
+}
+
+template <typename TracePolicy>
+bool BasicConcurrentHashMap<TracePolicy>::insert(const QString &key, const QString &value) {
+    const size_t hash = QtHash::hash(key);
+    Shard &shard = shards_[shardIndexOfHash(hash)];
+    ShardLocker locker(shard);
+    return shard.map.insert(key, value, hash);
+}
+
+template <typename TracePolicy>
+void BasicConcurrentHashMap<TracePolicy>::put(const QString &key, const QString &value) {
+    const size_t hash = QtHash::hash(key);
+    Shard &shard = shards_[shardIndexOfHash(hash)];
+    ShardLocker locker(shard);
+    shard.map.put(key, value, hash);
+}
+
+template <typename TracePolicy>
+std::optional<QString> BasicConcurrentHashMap<TracePolicy>::get(QStringView key) {
+    const size_t hash = QtHash::hash(key);
+    Shard &shard = shards_[shardIndexOfHash(hash)];
+    ShardLocker locker(shard);
+    return shard.map.get(key, hash);
+}
+
+template <typename TracePolicy>
+bool BasicConcurrentHashMap<TracePolicy>::erase(QStringView key) {
+    const size_t hash = QtHash::hash(key);
+    Shard &shard = shards_[shardIndexOfHash(hash)];
+    ShardLocker locker(shard);
+    return shard.map.erase(key, hash);
+}
+
+template <typename TracePolicy>
+bool BasicConcurrentHashMap<TracePolicy>::contains(QStringView key) {
+    const size_t hash = QtHash::hash(key);
+    Shard &shard = shards_[shardIndexOfHash(hash)];
+    ShardLocker locker(shard);
+    return shard.map.contains(key, hash);
+}
+
+template <typename TracePolicy>
+void BasicConcurrentHashMap<TracePolicy>::clear() {
+    for (int i = 0; i < shardCount_; ++i) {
+        ShardLocker locker(shards_[i]);
+        shards_[i].map.clear();
+    }
+}
+
+template <typename TracePolicy>
+int BasicConcurrentHashMap<TracePolicy>::size() const {
+    int total = 0;
+    for (int i = 0; i < shardCount_; ++i) {
+        ShardLocker locker(shards_[i]);
+        total += shards_[i].map.size();
+    }
+    return total;
+}
+
+template <typename TracePolicy>
+int BasicConcurrentHashMap<TracePolicy>::shardCount() const {
+    return shardCount_;
+}
+
+template <typename TracePolicy>
+typename BasicConcurrentHashMap<TracePolicy>::LockStats BasicConcurrentHashMap<TracePolicy>::lockStats() const {
+    LockStats stats;
+    for (int i = 0; i < shardCount_; ++i) {
+        const Shard &shard = shards_[i];
+        stats.acquisitions += shard.acquisitions.load(std::memory_order_relaxed);
+        stats.contended += shard.contended.load(std::memory_order_relaxed);
+        stats.waitNanos += shard.waitNanos.load(std::memory_order_relaxed);
+    }
+    return stats;
+}
+
+template <typename TracePolicy>
+void BasicConcurrentHashMap<TracePolicy>::resetLockStats() {
+    for (int i = 0; i < shardCount_; ++i) {
+        ShardLocker locker(shards_[i]);
+        shards_[i].acquisitions.store(0, std::memory_order_relaxed);
+        shards_[i].contended.store(0, std::memory_order_relaxed);
+        shards_[i].waitNanos.store(0, std::memory_order_relaxed);
+    }
+}
+
+template <typename TracePolicy>
+const HashStepTrace &BasicConcurrentHashMap<TracePolicy>::lastSteps(int shard) const {
+    return shards_[shard].map.lastSteps();
+}
+
+template class BasicConcurrentHashMap<NoTrace>;
+template class BasicConcurrentHashMap<StepTrace>;
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <QMutex>
+#include <QString>
+#include <QStringView>
+#include "hashmap.h"
+#include <atomic>
+#include <memory>
+#include <optional>
+
+// Thread-safe HashMap built from independently locked shards. Each shard is
+// a BasicHashMap behind its own mutex. The key is hashed once: the shard is
+// picked from the high bits of the mixed hash, so shard choice stays
+// independent of the bucket index, which each shard derives from the same
+// hash, and the shard map is handed the hash instead of hashing again.
+// Operations on different shards never wait on each other. Tracing is off
+// by default; with StepTrace each shard keeps its own trace, which is only
+// meaningful to a single-threaded observer.
+template <typename TracePolicy = NoTrace>
+class BasicConcurrentHashMap {
+public:
+    // Lock counters summed over all shards. A contended acquisition is one
+    // whose initial tryLock failed; waitNanos covers only those waits.
+    struct LockStats {
+        quint64 acquisitions = 0;
+        quint64 contended = 0;
+        quint64 waitNanos = 0;
+    };
+
+    // shardCount 0 picks four shards per hardware thread. expectedElements
+    // is spread evenly to presize every shard.
+    explicit BasicConcurrentHashMap(int shardCount = 0, int expectedElements = 0);
+
+    bool insert(const QString &key, const QString &value);
+    void put(const QString &key, const QString &value);
+    std::optional<QString> get(QStringView key);
+    bool erase(QStringView key);
+    bool contains(QStringView key);
+
+    // Clears shard by shard; not atomic with respect to concurrent writers.
+    void clear();
+
+    // Sums shard sizes one lock at a time, so the result is only exact when
+    // no writer runs concurrently.
+    int size() const;
+
+    int shardCount() const;
+    int shardIndexOf(QStringView key) const;
+
+    LockStats lockStats() const;
+    void resetLockStats();
+
+    // Trace of the last operation on one shard. Always empty under NoTrace.
+    const HashStepTrace &lastSteps(int shard) const;
+
+private:
+    struct alignas(64) Shard {
+        mutable QMutex mutex;
+        BasicHashMap<TracePolicy> map;
+        // Written only while holding mutex; atomics keep lockStats() reads
+        // tear-free without taking the lock.
+        std::atomic<quint64> acquisitions {0};
+        std::atomic<quint64> contended {0};
+        std::atomic<quint64> waitNanos {0};
+    };
+
+    // Locks a shard for the duration of one operation, recording contention.
+    class ShardLocker {
+    public:
+        explicit ShardLocker(Shard &shard);
+        ~ShardLocker();
+        Q_DISABLE_COPY_MOVE(ShardLocker)
+
+    private:
+        Shard &shard_;
+    };
+
+    std::unique_ptr<Shard[]> shards_;
+    int shardCount_ = 0;
+
+    int shardIndexOfHash(size_t hash) const;
+};
+
+using ConcurrentHashMap = BasicConcurrentHashMap<NoTrace>;
+
+extern template class BasicConcurrentHashMap<NoTrace>;
+extern template class BasicConcurrentHashMap<StepTrace>;
@@ -0,0 +1,75 @@
+#include "epochreclaimer.h"
+
+#include <algorithm>
+
+namespace {
+
+// Round-robin slot assignment, fixed for the lifetime of each thread.
+int currentSlot(int slotCount) {
+    static std::atomic<unsigned> nextThread {0};
+    thread_local const unsigned thread = nextThread.fetch_add(1, std::memory_order_relaxed);
+    return static_cast<int>(thread % static_cast<unsigned>(slotCount));
+}
+
+} // namespace
+
+EpochReclaimer::Guard::~Guard() {
+    active_.fetch_sub(1, std::memory_order_release);
+}
+
+EpochReclaimer::~EpochReclaimer() {
+    for (const Retired &r : retired_) {
+        r.deleter(r.object);
+    }
+}
+
+EpochReclaimer::Guard EpochReclaimer::pin() {
+    Slot &slot = slots_[currentSlot(kSlots)];
+    for (;;) {
+        const quint64 e = epoch_.load(std::memory_order_seq_cst);
+        std::atomic<int> &active = slot.active[e & 1];
+        active.fetch_add(1, std::memory_order_seq_cst);
+        // If the epoch moved between the load and the increment, a writer
+        // may already have checked this parity and found it empty; back out
+        // and register under the new epoch instead.
+        if (epoch_.load(std::memory_order_seq_cst) == e) {
+            return Guard(active);
+        }
+        active.fetch_sub(1, std::memory_order_release);
+    }
+}
+
+void EpochReclaimer::retire(void *p, Deleter deleter) {
+    retired_.push_back(Retired{p, deleter, epoch_.load(std::memory_order_relaxed)});
+    if (retired_.size() % kReclaimBatch == 0) {
+        reclaim();
+    }
+}
+
+bool EpochReclaimer::tryAdvance() {
+    // Moving from e to e + 1 requires that nobody is still pinned at e - 1,
+    // which shares a parity with e + 1.
+    const quint64 e = epoch_.load(std::memory_order_seq_cst);
+    const int parity = static_cast<int>((e + 1) & 1);
+    for (const Slot &slot : slots_) {
+        if (slot.active[parity].load(std::memory_order_seq_cst) != 0) return false;
+    }
+    epoch_.store(e + 1, std::memory_order_seq_cst);
+    return true;
+}
+
+void EpochReclaimer::reclaim() {
+    if (retired_.empty()) return;
+    // Two steps are enough to release everything retired before this call.
+    if (tryAdvance()) (void)tryAdvance();
+    const quint64 e = epoch_.load(std::memory_order_relaxed);
+    // Readers pinned at r or r - 1 may hold an object retired at r; both are
+    // gone once the epoch reaches r + 2.
+    const auto reachable = std::partition(retired_.begin(), retired_.end(), [e](const Retired &r) {
+        return r.epoch + 2 > e;
+    });
+    for (auto it = reachable; it != retired_.end(); ++it) {
+        it->deleter(it->object);
+    }
+    retired_.erase(reachable, retired_.end());
+}
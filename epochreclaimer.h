@@ -0,0 +1,75 @@
+#pragma once
+
+#include <QtGlobal>
+#include <atomic>
+#include <vector>
+
+// Epoch-based reclamation for structures whose readers run without locks.
+// Readers pin the current epoch for the duration of a traversal; writers
+// retire unlinked objects instead of deleting them, and an object is freed
+// once the global epoch has advanced twice past the epoch it was retired in,
+// at which point no reader can still hold a pointer to it.
+//
+// Reader state lives in cache-line-padded slots with one active counter per
+// epoch parity. Threads are spread over the slots round-robin, so pinning
+// touches only the thread's own line. pin() may be called from any thread;
+// retire() and reclaim() must be serialized by the caller (the owning
+// structure's writer lock).
+class EpochReclaimer {
+public:
+    using Deleter = void (*)(void *);
+
+    // RAII read-side critical section.
+    class Guard {
+    public:
+        ~Guard();
+        Q_DISABLE_COPY_MOVE(Guard)
+
+    private:
+        friend class EpochReclaimer;
+        Guard(std::atomic<int> &active) : active_(active) {}
+        std::atomic<int> &active_;
+    };
+
+    EpochReclaimer() = default;
+    ~EpochReclaimer(); // frees everything still retired; no readers may remain
+    Q_DISABLE_COPY_MOVE(EpochReclaimer)
+
+    Guard pin();
+
+    // Queues p for deleter(p) once no reader can reach it. Retiring
+    // periodically attempts reclamation.
+    void retire(void *p, Deleter deleter);
+
+    template <typename T>
+    void retire(T *p) {
+        retire(static_cast<void *>(p), [](void *q) { delete static_cast<T *>(q); });
+    }
+
+    // Advances the epoch if the readers of the previous epoch have drained,
+    // then frees every object that is now unreachable.
+    void reclaim();
+
+    int pendingCount() const { return static_cast<int>(retired_.size()); }
+    quint64 epoch() const { return epoch_.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr int kSlots = 64;
+    static constexpr int kReclaimBatch = 64;
+
+    struct alignas(64) Slot {
+        std::atomic<int> active[2] = {{0}, {0}};
+    };
+
+    struct Retired {
+        void *object;
+        Deleter deleter;
+        quint64 epoch;
+    };
+
+    std::atomic<quint64> epoch_ {2};
+    Slot slots_[kSlots];
+    std::vector<Retired> retired_;
+
+    bool tryAdvance();
+};
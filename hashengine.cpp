@@ -0,0 +1,126 @@
+#include "hashengine.h"
+
+#include "hashmap.h"
+#include "robinhoodhashmap.h"
+#include "swisshashmap.h"
+
+static_assert(HashEngine::kEmptyControl == SwissHashMap::kEmpty);
+static_assert(HashEngine::kDeletedControl == SwissHashMap::kDeleted);
+
+namespace {
+
+// Engine-specific views; engines without the concept report nothing.
+QVector<int> probeLengthsOf(const RobinHoodHashMap &map) { return map.probeLengths(); }
+template <typename Map>
+QVector<int> probeLengthsOf(const Map &) { return QVector<int>(); }
+
+QVector<int> controlBytesOf(const SwissHashMap &map) { return map.controlBytes(); }
+template <typename Map>
+QVector<int> controlBytesOf(const Map &) { return QVector<int>(); }
+
+template <typename T, typename I, typename H>
+QVector<int> chainHistogramOf(const BasicHashMap<T, I, H> &map) { return map.chainLengthHistogram(); }
+template <typename Map>
+QVector<int> chainHistogramOf(const Map &) { return QVector<int>(); }
+
+template <typename T, typename I, typename H>
+void setBloomFilterOf(BasicHashMap<T, I, H> &map, bool enabled) { map.setBloomFilter(enabled); }
+template <typename Map>
+void setBloomFilterOf(Map &, bool) {}
+
+template <typename T, typename I, typename H>
+QStringList bucketKeysOf(const BasicHashMap<T, I, H> &map, int bucket) {
+    QStringList keys;
+    for (auto it = map.bucket(bucket).begin(), end = map.bucket(bucket).end(); it != end; ++it) {
+        keys.append(it.key());
+    }
+    return keys;
+}
+template <typename Map>
+QStringList bucketKeysOf(const Map &, int) { return QStringList(); }
+
+template <typename T, typename I, typename H>
+int longestChainOf(const BasicHashMap<T, I, H> &map) { return map.longestChain(); }
+template <typename Map>
+int longestChainOf(const Map &) { return 0; }
+
+// The visualizer runs one operation at a time, so every one is timed.
+template <typename T, typename I, typename H>
+void enableMetricsOf(BasicHashMap<T, I, H> &map) { map.setMetricsEnabled(true, /*sampleEvery=*/1); }
+template <typename Map>
+void enableMetricsOf(Map &) {}
+
+template <typename T, typename I, typename H>
+HashMapMetrics metricsOf(const BasicHashMap<T, I, H> &map) { return map.metrics(); }
+template <typename Map>
+HashMapMetrics metricsOf(const Map &) { return HashMapMetrics(); }
+
+template <typename Map>
+class HashEngineAdapter : public HashEngine {
+public:
+    HashEngineAdapter(HashEngineKind kind, const QString &name, int initialBucketCount)
+        : kind_(kind), name_(name), map_(initialBucketCount) {
+        enableMetricsOf(map_);
+    }
+
+    HashEngineKind kind() const override { return kind_; }
+    QString name() const override { return name_; }
+    bool isOpenAddressing() const override { return kind_ != HashEngineKind::Chaining; }
+
+    bool insert(const QString &key, const QString &value) override { return map_.insert(key, value); }
+    void put(const QString &key, const QString &value) override { map_.put(key, value); }
+    std::optional<QString> get(const QString &key) override { return map_.get(key); }
+    bool erase(const QString &key) override { return map_.erase(key); }
+    void clear() override { map_.clear(); }
+
+    int size() const override { return map_.size(); }
+    int bucketCount() const override { return map_.bucketCount(); }
+    float loadFactor() const override { return map_.loadFactor(); }
+
+    void setBloomFilter(bool enabled) override { setBloomFilterOf(map_, enabled); }
+
+    const HashStepTrace &lastSteps() const override { return map_.lastSteps(); }
+    QVector<int> bucketSizes() const override { return map_.bucketSizes(); }
+    QStringList bucketKeys(int bucket) const override { return bucketKeysOf(map_, bucket); }
+    QVector<int> chainLengthHistogram() const override { return chainHistogramOf(map_); }
+    int longestChain() const override { return longestChainOf(map_); }
+    HashMapMetrics metrics() const override { return metricsOf(map_); }
+
+    QVector<int> probeLengths() const override { return probeLengthsOf(map_); }
+    QVector<int> controlBytes() const override { return controlBytesOf(map_); }
+
+private:
+    HashEngineKind kind_;
+    QString name_;
+    Map map_;
+};
+
+} // namespace
+
+std::unique_ptr<HashEngine> makeHashEngine(HashEngineKind kind, int initialBucketCount, HashFunctionKind hash) {
+    switch (kind) {
+    case HashEngineKind::RobinHood:
+        return std::make_unique<HashEngineAdapter<RobinHoodHashMap>>(
+            kind, QStringLiteral("Robin Hood probing"), initialBucketCount);
+    case HashEngineKind::Swiss:
+        return std::make_unique<HashEngineAdapter<SwissHashMap>>(
+            kind, QStringLiteral("Swiss table"), initialBucketCount);
+    case HashEngineKind::Chaining:
+        break;
+    }
+    const QString name = QStringLiteral("Separate chaining");
+    switch (hash) {
+    case HashFunctionKind::Wy:
+        return std::make_unique<HashEngineAdapter<BasicHashMap<StepTrace, ModuloIndex, WyHash>>>(
+            HashEngineKind::Chaining, name, initialBucketCount);
+    case HashFunctionKind::Xxh3:
+        return std::make_unique<HashEngineAdapter<BasicHashMap<StepTrace, ModuloIndex, XxHash3>>>(
+            HashEngineKind::Chaining, name, initialBucketCount);
+    case HashFunctionKind::Fnv1a:
+        return std::make_unique<HashEngineAdapter<BasicHashMap<StepTrace, ModuloIndex, Fnv1aHash>>>(
+            HashEngineKind::Chaining, name, initialBucketCount);
+    case HashFunctionKind::Qt:
+        break;
+    }
+    return std::make_unique<HashEngineAdapter<HashMap>>(HashEngineKind::Chaining, name, initialBucketCount);
+}
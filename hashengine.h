@@ -0,0 +1,75 @@
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include "hashmetrics.h"
+#include "hashstep.h"
+#include <memory>
+#include <optional>
+
+// Storage engines the visualizer can switch between.
+enum class HashEngineKind {
+    Chaining,
+    RobinHood,
+    Swiss,
+};
+
+// Hash functions the chaining engine can be built with (see hashfunctions.h).
+// Robin Hood and Swiss engines always use qHash.
+enum class HashFunctionKind {
+    Qt,
+    Wy,
+    Xxh3,
+    Fnv1a,
+};
+
+// Type-erased view of a tracing hash map engine, used by the visualizer so it
+// can switch engines at runtime. Headless code should use the engine
+// templates directly to avoid the virtual dispatch.
+class HashEngine {
+public:
+    virtual ~HashEngine() = default;
+
+    virtual HashEngineKind kind() const = 0;
+    virtual QString name() const = 0;
+    // True when buckets are single slots with probe sequences, not chains.
+    virtual bool isOpenAddressing() const = 0;
+
+    virtual bool insert(const QString &key, const QString &value) = 0;
+    virtual void put(const QString &key, const QString &value) = 0;
+    virtual std::optional<QString> get(const QString &key) = 0;
+    virtual bool erase(const QString &key) = 0;
+    virtual void clear() = 0;
+
+    virtual int size() const = 0;
+    virtual int bucketCount() const = 0;
+    virtual float loadFactor() const = 0;
+
+    // Only the chaining engine has a Bloom filter; the others ignore this.
+    virtual void setBloomFilter(bool enabled) = 0;
+
+    virtual const HashStepTrace &lastSteps() const = 0;
+    virtual QVector<int> bucketSizes() const = 0;
+    // Keys chained in one bucket, in chain order; empty unless chaining.
+    virtual QStringList bucketKeys(int bucket) const = 0;
+    // Buckets per chain length and the longest chain; empty and 0 unless
+    // chaining. Both are maintained by the map, so reading them is O(1)
+    // outside an incremental migration.
+    virtual QVector<int> chainLengthHistogram() const = 0;
+    virtual int longestChain() const = 0;
+    // Counters and latency percentiles since the engine was built; all zero
+    // unless chaining.
+    virtual HashMapMetrics metrics() const = 0;
+    // Probe distance per slot (-1 = empty); empty unless Robin Hood.
+    virtual QVector<int> probeLengths() const = 0;
+    // Swiss-table control byte per slot: 0..127 = stored hash bits, else
+    // kEmptyControl or kDeletedControl; empty unless Swiss.
+    virtual QVector<int> controlBytes() const = 0;
+
+    static constexpr int kEmptyControl = -128;
+    static constexpr int kDeletedControl = -2;
+};
+
+std::unique_ptr<HashEngine> makeHashEngine(HashEngineKind kind, int initialBucketCount,
+                                           HashFunctionKind hash = HashFunctionKind::Qt);
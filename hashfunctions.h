@@ -0,0 +1,260 @@
+#pragma once
+
+#include <QHashFunctions>
+#include <QString>
+#include <QStringView>
+#include <QtGlobal>
+#include "hashindex.h"
+#include <cstring>
+
+#if defined(_MSC_VER)
+#include <stdlib.h>
+#endif
+
+// Hash policies for BasicHashMap. Each policy hashes the UTF-16 code units
+// of a key and provides:
+//   static size_t hash(QStringView key)
+//   static constexpr const char *name
+//   static constexpr bool seeded   - results change between processes
+// QtHash keeps the historical qHash behaviour; the others are portable
+// 64-bit functions whose results do not depend on Qt's per-process seed.
+
+namespace hashfn {
+
+inline quint64 byteSwap64(quint64 v) {
+#if defined(_MSC_VER)
+    return _byteswap_uint64(v);
+#else
+    return __builtin_bswap64(v);
+#endif
+}
+
+inline quint32 byteSwap32(quint32 v) {
+#if defined(_MSC_VER)
+    return _byteswap_ulong(v);
+#else
+    return __builtin_bswap32(v);
+#endif
+}
+
+inline quint64 readLE64(const uchar *p) {
+    quint64 v;
+    std::memcpy(&v, p, sizeof(v));
+#if Q_BYTE_ORDER == Q_BIG_ENDIAN
+    v = byteSwap64(v);
+#endif
+    return v;
+}
+
+inline quint32 readLE32(const uchar *p) {
+    quint32 v;
+    std::memcpy(&v, p, sizeof(v));
+#if Q_BYTE_ORDER == Q_BIG_ENDIAN
+    v = byteSwap32(v);
+#endif
+    return v;
+}
+
+inline quint64 rotl64(quint64 v, int r) { return (v << r) | (v >> (64 - r)); }
+
+// Low and high halves of the 128-bit product, xor-folded.
+inline quint64 mulFold64(quint64 a, quint64 b) { return (a * b) ^ hashindex::mulHigh64(a, b); }
+
+// FNV-1a, 64-bit.
+inline quint64 fnv1a64(const uchar *p, size_t len) {
+    quint64 h = 0xcbf29ce484222325ull;
+    for (size_t i = 0; i < len; ++i) {
+        h ^= p[i];
+        h *= 0x100000001b3ull;
+    }
+    return h;
+}
+
+// wyhash (final version 4) with the default secret.
+inline quint64 wyhash64(const uchar *p, size_t len, quint64 seed = 0) {
+    static constexpr quint64 kSecret[4] = {
+        0x2d358dccaa6c78a5ull, 0x8bb84b93962eacc9ull, 0x4b33a62ed433d4a3ull, 0x4d5a2da51de1aa47ull,
+    };
+    const auto mix = [](quint64 a, quint64 b) { return mulFold64(a, b); };
+    seed ^= mix(seed ^ kSecret[0], kSecret[1]);
+    quint64 a = 0;
+    quint64 b = 0;
+    if (len <= 16) {
+        if (len >= 4) {
+            const size_t shift = (len >> 3) << 2;
+            a = (quint64(readLE32(p)) << 32) | readLE32(p + shift);
+            b = (quint64(readLE32(p + len - 4)) << 32) | readLE32(p + len - 4 - shift);
+        } else if (len > 0) {
+            a = (quint64(p[0]) << 16) | (quint64(p[len >> 1]) << 8) | p[len - 1];
+        }
+    } else {
+        size_t i = len;
+        if (i >= 48) {
+            quint64 see1 = seed;
+            quint64 see2 = seed;
+            do {
+                seed = mix(readLE64(p) ^ kSecret[1], readLE64(p + 8) ^ seed);
+                see1 = mix(readLE64(p + 16) ^ kSecret[2], readLE64(p + 24) ^ see1);
+                see2 = mix(readLE64(p + 32) ^ kSecret[3], readLE64(p + 40) ^ see2);
+                p += 48;
+                i -= 48;
+            } while (i >= 48);
+            seed ^= see1 ^ see2;
+        }
+        while (i > 16) {
+            seed = mix(readLE64(p) ^ kSecret[1], readLE64(p + 8) ^ seed);
+            i -= 16;
+            p += 16;
+        }
+        a = readLE64(p + i - 16);
+        b = readLE64(p + i - 8);
+    }
+    a ^= kSecret[1];
+    b ^= seed;
+    const quint64 lo = a * b;
+    const quint64 hi = hashindex::mulHigh64(a, b);
+    return mix(lo ^ kSecret[0] ^ len, hi ^ kSecret[1]);
+}
+
+// XXH3 64-bit, seed 0, default secret. Inputs up to 240 bytes take the
+// inline paths; longer ones go through the striped loop in hashfunctions.cpp.
+namespace xxh3 {
+
+constexpr quint64 kPrime32_1 = 0x9E3779B1u;
+constexpr quint64 kPrime32_2 = 0x85EBCA77u;
+constexpr quint64 kPrime32_3 = 0xC2B2AE3Du;
+constexpr quint64 kPrime64_1 = 0x9E3779B185EBCA87ull;
+constexpr quint64 kPrime64_2 = 0xC2B2AE3D27D4EB4Full;
+constexpr quint64 kPrime64_3 = 0x165667B19E3779F9ull;
+constexpr quint64 kPrime64_4 = 0x85EBCA77C2B2AE63ull;
+constexpr quint64 kPrime64_5 = 0x27D4EB2F165667C5ull;
+constexpr quint64 kPrimeMx1 = 0x165667919E3779F9ull;
+constexpr quint64 kPrimeMx2 = 0x9FB21C651E98DF25ull;
+
+extern const uchar kSecret[192];
+
+inline quint64 xxh64Avalanche(quint64 h) {
+    h ^= h >> 33;
+    h *= kPrime64_2;
+    h ^= h >> 29;
+    h *= kPrime64_3;
+    h ^= h >> 32;
+    return h;
+}
+
+inline quint64 avalanche(quint64 h) {
+    h ^= h >> 37;
+    h *= kPrimeMx1;
+    h ^= h >> 32;
+    return h;
+}
+
+inline quint64 rrmxmx(quint64 h, quint64 len) {
+    h ^= rotl64(h, 49) ^ rotl64(h, 24);
+    h *= kPrimeMx2;
+    h ^= (h >> 35) + len;
+    h *= kPrimeMx2;
+    h ^= h >> 28;
+    return h;
+}
+
+inline quint64 mix16(const uchar *p, const uchar *secret) {
+    return mulFold64(readLE64(p) ^ readLE64(secret), readLE64(p + 8) ^ readLE64(secret + 8));
+}
+
+quint64 hashLong(const uchar *p, size_t len);
+
+inline quint64 hash64(const uchar *p, size_t len) {
+    const uchar *s = kSecret;
+    if (len == 0) {
+        return xxh64Avalanche(readLE64(s + 56) ^ readLE64(s + 64));
+    }
+    if (len <= 3) {
+        const quint32 combined = (quint32(p[0]) << 16) | (quint32(p[len >> 1]) << 24)
+            | quint32(p[len - 1]) | (quint32(len) << 8);
+        const quint64 bitflip = readLE32(s) ^ readLE32(s + 4);
+        return xxh64Avalanche(combined ^ bitflip);
+    }
+    if (len <= 8) {
+        const quint64 bitflip = readLE64(s + 8) ^ readLE64(s + 16);
+        const quint64 input = readLE32(p + len - 4) + (quint64(readLE32(p)) << 32);
+        return rrmxmx(input ^ bitflip, len);
+    }
+    if (len <= 16) {
+        const quint64 lo = readLE64(p) ^ (readLE64(s + 24) ^ readLE64(s + 32));
+        const quint64 hi = readLE64(p + len - 8) ^ (readLE64(s + 40) ^ readLE64(s + 48));
+        const quint64 acc = len + byteSwap64(lo) + hi + mulFold64(lo, hi);
+        return avalanche(acc);
+    }
+    if (len <= 128) {
+        quint64 acc = len * kPrime64_1;
+        if (len > 32) {
+            if (len > 64) {
+                if (len > 96) {
+                    acc += mix16(p + 48, s + 96);
+                    acc += mix16(p + len - 64, s + 112);
+                }
+                acc += mix16(p + 32, s + 64);
+                acc += mix16(p + len - 48, s + 80);
+            }
+            acc += mix16(p + 16, s + 32);
+            acc += mix16(p + len - 32, s + 48);
+        }
+        acc += mix16(p, s);
+        acc += mix16(p + len - 16, s + 16);
+        return avalanche(acc);
+    }
+    if (len <= 240) {
+        quint64 acc = len * kPrime64_1;
+        const size_t rounds = len / 16;
+        for (size_t i = 0; i < 8; ++i) acc += mix16(p + 16 * i, s + 16 * i);
+        acc = avalanche(acc);
+        for (size_t i = 8; i < rounds; ++i) acc += mix16(p + 16 * i, s + 16 * (i - 8) + 3);
+        acc += mix16(p + len - 16, s + 136 - 17);
+        return avalanche(acc);
+    }
+    return hashLong(p, len);
+}
+
+} // namespace xxh3
+
+inline const uchar *bytesOf(QStringView key) { return reinterpret_cast<const uchar *>(key.utf16()); }
+inline size_t byteSizeOf(QStringView key) { return static_cast<size_t>(key.size()) * sizeof(char16_t); }
+
+} // namespace hashfn
+
+struct QtHash {
+    static constexpr const char *name = "qHash";
+    static constexpr bool seeded = true;
+    static size_t hash(QStringView key) { return static_cast<size_t>(qHash(key)); }
+};
+
+struct WyHash {
+    static constexpr const char *name = "wyhash";
+    static constexpr bool seeded = false;
+    static size_t hash(QStringView key) {
+        return static_cast<size_t>(hashfn::wyhash64(hashfn::bytesOf(key), hashfn::byteSizeOf(key)));
+    }
+};
+
+struct XxHash3 {
+    static constexpr const char *name = "xxHash3";
+    static constexpr bool seeded = false;
+    static size_t hash(QStringView key) {
+        return static_cast<size_t>(hashfn::xxh3::hash64(hashfn::bytesOf(key), hashfn::byteSizeOf(key)));
+    }
+};
+
+struct Fnv1aHash {
+    static constexpr const char *name = "FNV-1a";
+    static constexpr bool seeded = false;
+    static size_t hash(QStringView key) {
+        return static_cast<size_t>(hashfn::fnv1a64(hashfn::bytesOf(key), hashfn::byteSizeOf(key)));
+    }
+};
+
+// Checks WyHash, XxHash3 and Fnv1aHash against known answers at every size
+// class. Snapshots store these hashes on disk, so a change in any of them
+// breaks existing files; headless tools run this at startup. On mismatch
+// returns false and says which function and length failed.
+bool verifyHashFunctions(QString *errorString = nullptr);
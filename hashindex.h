@@ -0,0 +1,148 @@
+#pragma once
+
+#include <QtGlobal>
+#include "hashstep.h"
+#include <array>
+#include <cstddef>
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+// Bucket index policies for BasicHashMap. Each policy keeps whatever it
+// precomputes for the current bucket count and provides:
+//   static int roundBucketCount(int requested) - nearest supported count >= requested
+//   void setBucketCount(int count)
+//   int index(size_t hash) const
+//   static constexpr HashStepOp traceOp        - how the step trace labels it
+
+namespace hashindex {
+
+// High 64 bits of a 64x64-bit product.
+inline quint64 mulHigh64(quint64 a, quint64 b) {
+#if defined(__SIZEOF_INT128__)
+    return static_cast<quint64>((static_cast<unsigned __int128>(a) * b) >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    return __umulh(a, b);
+#else
+    const quint64 aLo = a & 0xffffffffu, aHi = a >> 32;
+    const quint64 bLo = b & 0xffffffffu, bHi = b >> 32;
+    const quint64 lolo = aLo * bLo;
+    const quint64 hilo = aHi * bLo;
+    const quint64 lohi = aLo * bHi;
+    const quint64 cross = (lolo >> 32) + (hilo & 0xffffffffu) + lohi;
+    return aHi * bHi + (hilo >> 32) + (cross >> 32);
+#endif
+}
+
+// Folds a size_t hash to 32 bits without discarding the high half.
+inline quint32 fold32(size_t hash) {
+    const quint64 h = static_cast<quint64>(hash);
+    return static_cast<quint32>(h ^ (h >> 32));
+}
+
+// Bucket counts for PrimeIndex, roughly doubling, each far from a power of two.
+constexpr std::array<quint32, 30> kPrimes = {{
+    5u, 11u, 23u, 53u, 97u, 193u, 389u, 769u, 1543u, 3079u, 6151u, 12289u,
+    24593u, 49157u, 98317u, 196613u, 393241u, 786433u, 1572869u, 3145739u,
+    6291469u, 12582917u, 25165843u, 50331653u, 100663319u, 201326611u,
+    402653189u, 805306457u, 1610612741u, 2147483647u,
+}};
+
+// Lemire fastmod reciprocal: ceil(2^64 / divisor).
+constexpr quint64 fastModMagic(quint32 divisor) { return ~quint64(0) / divisor + 1; }
+
+constexpr std::array<quint64, kPrimes.size()> makePrimeMagics() {
+    std::array<quint64, kPrimes.size()> magics {};
+    for (size_t i = 0; i < kPrimes.size(); ++i) magics[i] = fastModMagic(kPrimes[i]);
+    return magics;
+}
+
+constexpr std::array<quint64, kPrimes.size()> kPrimeMagics = makePrimeMagics();
+
+} // namespace hashindex
+
+// hash % count with a hardware division. Accepts any bucket count.
+struct ModuloIndex {
+    static constexpr HashStepOp traceOp = HashStepOp::ComputeIndex;
+
+    static int roundBucketCount(int requested) { return requested < 1 ? 1 : requested; }
+    void setBucketCount(int count) { count_ = static_cast<size_t>(count); }
+    int index(size_t hash) const { return static_cast<int>(hash % count_); }
+
+private:
+    size_t count_ = 1;
+};
+
+// Power-of-two bucket counts indexed with a mask. A 64-bit finalizer
+// (MurmurHash3 fmix64) mixes the high bits down first so weak low bits in
+// the hash don't collapse onto a few buckets.
+struct PowerOfTwoIndex {
+    static constexpr HashStepOp traceOp = HashStepOp::ComputeIndexMask;
+
+    static int roundBucketCount(int requested) {
+        int count = 1;
+        while (count < requested && count < (1 << 30)) count <<= 1;
+        return count;
+    }
+    void setBucketCount(int count) { mask_ = static_cast<quint64>(count - 1); }
+    int index(size_t hash) const {
+        quint64 h = static_cast<quint64>(hash);
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ULL;
+        h ^= h >> 33;
+        return static_cast<int>(h & mask_);
+    }
+
+private:
+    quint64 mask_ = 0;
+};
+
+// Prime bucket counts from a fixed table, reduced with Lemire's fastmod:
+// a precomputed 64-bit reciprocal turns the modulo into two multiplications.
+struct PrimeIndex {
+    static constexpr HashStepOp traceOp = HashStepOp::ComputeIndexFastMod;
+
+    static int roundBucketCount(int requested) {
+        for (quint32 prime : hashindex::kPrimes) {
+            if (prime >= static_cast<quint32>(requested < 1 ? 1 : requested)) return static_cast<int>(prime);
+        }
+        return static_cast<int>(hashindex::kPrimes.back());
+    }
+    void setBucketCount(int count) {
+        divisor_ = static_cast<quint32>(count);
+        magic_ = hashindex::fastModMagic(divisor_); // only for counts outside the table
+        for (size_t i = 0; i < hashindex::kPrimes.size(); ++i) {
+            if (hashindex::kPrimes[i] == divisor_) {
+                magic_ = hashindex::kPrimeMagics[i];
+                break;
+            }
+        }
+    }
+    int index(size_t hash) const {
+        const quint64 lowbits = magic_ * hashindex::fold32(hash);
+        return static_cast<int>(hashindex::mulHigh64(lowbits, divisor_));
+    }
+
+private:
+    quint32 divisor_ = 1;
+    quint64 magic_ = 0;
+};
+
+// Lemire's fastrange: maps a 32-bit hash onto [0, count) with one multiply
+// and a shift. Any bucket count works, but it relies on the hash having
+// well-mixed high bits.
+struct FastRangeIndex {
+    static constexpr HashStepOp traceOp = HashStepOp::ComputeIndexRange;
+
+    static int roundBucketCount(int requested) { return requested < 1 ? 1 : requested; }
+    void setBucketCount(int count) { count_ = static_cast<quint64>(count); }
+    int index(size_t hash) const {
+        return static_cast<int>((static_cast<quint64>(hashindex::fold32(hash)) * count_) >> 32);
+    }
+
+private:
+    quint64 count_ = 1;
+};
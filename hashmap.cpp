@@ -1,219 +1,867 @@
 #include "hashmap.h"
 
+#include <QByteArrayView>
+#include <QElapsedTimer>
+#include <QStringDecoder>
+#include <QVarLengthArray>
+#include "hashsnapshot.h"
 #include <algorithm>
+#include <cmath>
 
-HashMap::HashMap(int initialBucketCount, float maxLoadFactor)
-    : buckets_(static_cast<size_t>(std::max(1, initialBucketCount))),
+namespace {
+
+// Stack storage for decoded 8-bit probe keys; longer keys spill to the heap.
+using KeyBuffer = QVarLengthArray<QChar, 128>;
+
+// Latin-1 and UTF-8 keys are widened to UTF-16 so they hash and compare
+// exactly like the QString keys stored in the map.
+QStringView decodeKey(QLatin1StringView key, KeyBuffer &buffer) {
+    buffer.resize(key.size());
+    for (qsizetype i = 0; i < key.size(); ++i)
+        buffer[i] = QChar(key.at(i));
+    return QStringView(buffer.constData(), buffer.size());
+}
+
+QStringView decodeKey(QUtf8StringView key, KeyBuffer &buffer) {
+    QStringDecoder decoder(QStringDecoder::Utf8);
+    buffer.resize(decoder.requiredSpace(key.size()));
+    const QChar *end = decoder.appendToBuffer(
+        buffer.data(), QByteArrayView(reinterpret_cast<const char *>(key.data()), key.size()));
+    return QStringView(buffer.constData(), end - buffer.constData());
+}
+
+} // namespace
+
+template <typename TracePolicy, typename IndexPolicy, typename HashPolicy>
+BasicHashMap<TracePolicy, IndexPolicy, HashPolicy>::BasicHashMap(int initialBucketCount, float maxLoadFactor)
+    : freeList_(kNil),
       numElements_(0),
-      maxLoadFactor_(maxLoadFactor) {
-    lastSteps_.clear();
+      maxLoadFactor_(maxLoadFactor),
+      minLoadFactor_(std::min(0.1f, maxLoadFactor / 4.0f)) {
+    resetBuckets(initialBucketCount);
+    minBucketCount_ = bucketCount();
+}
+
+template <typename TracePolicy, typename IndexPolicy, typename HashPolicy>
+void BasicHashMap<TracePolicy, IndexPolicy, HashPolicy>::resetBuckets(int newBucketCount) {
+    const int count = IndexPolicy::roundBucketCount(std::max(1, newBucketCount));
+    heads_.assign(static_cast<size_t>(count), kNil);
+    index_.setBucketCount(count);
+    resetOccupancy();
+}
+
+template <typename TracePolicy, typename IndexPolicy, typename HashPolicy>
+void BasicHashMap<TracePolicy, IndexPolicy, HashPolicy>::resetOccupancy() {
+    const int count = static_cast<int>(heads_.size());
+    // Assigned rather than filled so a shrink also releases the old array.
+    bucketSizes_ = QVector<int>(count, 0);
+    chainHistogram_.fill(0, 1);
+    chainHistogram_[0] = count;
+    longestChain_ = 0;
 }
 
-void HashMap::addStep(const QString &text) {
-    lastSteps_.push_back(text);
+template <typename TracePolicy, typename IndexPolicy, typename HashPolicy>
+void BasicHashMap<TracePolicy, IndexPolicy, HashPolicy>::countAdded(int bucket) {
+    const int length = ++bucketSizes_[bucket];
+    if (length == chainHistogram_.size()) chainHistogram_.push_back(0);
+    --chainHistogram_[length - 1];
+    ++chainHistogram_[length];
+    longestChain_ = std::max(longestChain_, length);
 }
 
-void HashMap::clearSteps() {
-    lastSteps_.clear();
+template <typename TracePolicy, typename IndexPolicy, typename HashPolicy>
+void BasicHashMap<TracePolicy, IndexPolicy, HashPolicy>::countRemoved(int bucket) {
+    const int length = --bucketSizes_[bucket];
+    --chainHistogram_[length + 1];
+    ++chainHistogram_[length];
+    // The shortened chain now has length `length`, so the maximum drops by
+    // at most one.
+    if (length + 1 == longestChain_ && chainHistogram_[longestChain_] == 0) --longestChain_;
 }
 
-const QVector<QString> &HashMap::lastSteps() const {
-    return lastSteps_;
+template <typename TracePolicy, typename IndexPolicy, typename HashPolicy>
+bool BasicHashMap<TracePolicy, IndexPolicy, HashPolicy>::inCurrentTable(size_t hash) const {
+    return oldHeads_.empty() || static_cast<size_t>(oldIndex_.index(hash)) < migrateCursor_;
 }
 
-int HashMap::size() const {
+template <typename TracePolicy, typename IndexPolicy, typename HashPolicy>
+void BasicHashMap<TracePolicy, IndexPolicy, HashPolicy>::clearSteps() {
+    trace_.clear();
+}
+
+template <typename TracePolicy, typename IndexPolicy, typename HashPolicy>
+const HashStepTrace &BasicHashMap<TracePolicy, IndexPolicy, HashPolicy>::lastSteps() const {
+    return trace_.steps();
+}
+
+template <typename TracePolicy, typename IndexPolicy, typename HashPolicy>
+int BasicHashMap<TracePolicy, IndexPolicy, HashPolicy>::size() const {
     return numElements_;
 }
 
-int HashMap::bucketCount() const {
-    return static_cast<int>(buckets_.size());
+template <typename TracePolicy, typename IndexPolicy, typename HashPolicy>
+int BasicHashMap<TracePolicy, IndexPolicy, HashPolicy>::bucketCount() const {
+    return static_cast<int>(heads_.size());
 }
 
-float HashMap::loadFactor() const {
-    if (buckets_.empty()) return 0.0f;
-    return static_cast<float>(numElements_) / static_cast<float>(buckets_.size());
+template <typename TracePolicy, typename IndexPolicy, typename HashPolicy>
+float BasicHashMap<TracePolicy, IndexPolicy, HashPolicy>::loadFactor() const {
+    if (heads_.empty()) return 0.0f;
+    return static_cast<float>(numElements_) / static_cast<float>(heads_.size());
 }
 
-void HashMap::maybeGrow() {
+template <typename TracePolicy, typename IndexPolicy, typename HashPolicy>
+void BasicHashMap<TracePolicy, IndexPolicy, HashPolicy>::maybeGrow() {
     const float projected = (static_cast<float>(numElements_) + 1.0f)
-        / static_cast<float>(buckets_.empty() ? 1 : buckets_.size());
+        / static_cast<float>(heads_.empty() ? 1 : heads_.size());
     if (projected > maxLoadFactor_) {
-        const int newCount = std::max(2, bucketCount() * 2);
-        addStep(QStringLiteral("Load factor %.2f exceeds %.2f → rehash to %1 buckets")
-                    .arg(newCount)
-                    .arg(loadFactor(), 0, 'f', 2)
-                    .arg(maxLoadFactor_, 0, 'f', 2));
-        rehash(newCount);
+        const int newCount = IndexPolicy::roundBucketCount(std::max(2, bucketCount() * 2));
+        trace_.add(HashStepOp::GrowRehash, [&](HashStep &s) {
+            s.bucket = newCount;
+            s.loadFactor = loadFactor();
+            s.loadFactor2 = maxLoadFactor_;
+        });
+        beginResize(newCount);
+    }
+}
+
+template <typename TracePolicy, typename IndexPolicy, typename HashPolicy>
+void BasicHashMap<TracePolicy, IndexPolicy, HashPolicy>::maybeShrink() {
+    // A migration in flight already moves towards the right size; checking
+    // again once it is done keeps the two resizes from overlapping.
+    if (minLoadFactor_ <= 0.0f || !oldHeads_.empty() || bucketCount() <= minBucketCount_) return;
+    if (loadFactor() >= minLoadFactor_) return;
+
+    const float targetLoad = (minLoadFactor_ + maxLoadFactor_) / 2.0f;
+    const int newCount = IndexPolicy::roundBucketCount(
+        std::max(minBucketCount_, static_cast<int>(std::ceil(numElements_ / targetLoad))));
+    if (newCount >= bucketCount()) return;
+    trace_.add(HashStepOp::ShrinkRehash, [&](HashStep &s) {
+        s.bucket = newCount;
+        s.loadFactor = loadFactor();
+        s.loadFactor2 = minLoadFactor_;
+    });
+    beginResize(newCount);
+}
+
+template <typename TracePolicy, typename IndexPolicy, typename HashPolicy>
+void BasicHashMap<TracePolicy, IndexPolicy, HashPolicy>::beginResize(int newBucketCount) {
+    if (incrementalRehash_) {
+        // Finish any earlier migration, then park the current buckets as
+        // the old table and start filling an empty one.
+        finishMigration();
+        trace_.add(HashStepOp::MigrateStart, [&](HashStep &s) {
+            s.bucket = newBucketCount;
+            s.count = bucketCount();
+        });
+        if (metrics_) metrics_->countRehash();
+        oldHeads_.swap(heads_);
+        oldIndex_ = index_;
+        resetBuckets(newBucketCount);
+        migrateCursor_ = 0;
+        if (filterEnabled_) nextFilter_.reset(filterCapacity(bucketCount()), filterBitsPerKey_);
+        nextFilterStale_ = 0;
+    } else {
+        rehash(newBucketCount);
     }
 }
 
-bool HashMap::emplaceOrAssign(const QString &key, const QString &value, bool assignIfExists) {
+template <typename TracePolicy, typename IndexPolicy, typename HashPolicy>
+void BasicHashMap<TracePolicy, IndexPolicy, HashPolicy>::setMinLoadFactor(float minLoadFactor) {
+    minLoadFactor_ = std::clamp(minLoadFactor, 0.0f, maxLoadFactor_ / 4.0f);
+}
+
+template <typename TracePolicy, typename IndexPolicy, typename HashPolicy>
+float BasicHashMap<TracePolicy, IndexPolicy, HashPolicy>::minLoadFactor() const {
+    return minLoadFactor_;
+}
+
+template <typename TracePolicy, typename IndexPolicy, typename HashPolicy>
+void BasicHashMap<TracePolicy, IndexPolicy, HashPolicy>::setBloomFilter(bool enabled, int bitsPerKey) {
+    // Starting from a settled table saves seeding nextFilter_ mid-migration.
+    finishMigration();
+    filterEnabled_ = enabled;
+    filterBitsPerKey_ = std::max(1, bitsPerKey);
+    if (enabled) {
+        rebuildFilter();
+    } else {
+        filter_ = BlockedBloomFilter();
+        filterStale_ = 0;
+    }
+}
+
+template <typename TracePolicy, typename IndexPolicy, typename HashPolicy>
+bool BasicHashMap<TracePolicy, IndexPolicy, HashPolicy>::hasBloomFilter() const {
+    return filterEnabled_;
+}
+
+template <typename TracePolicy, typename IndexPolicy, typename HashPolicy>
+qsizetype BasicHashMap<TracePolicy, IndexPolicy, HashPolicy>::filterCapacity(int buckets) const {
+    return std::max<qsizetype>(numElements_, static_cast<qsizetype>(std::ceil(buckets * maxLoadFactor_)));
+}
+
+template <typename TracePolicy, typename IndexPolicy, typename HashPolicy>
+void BasicHashMap<TracePolicy, IndexPolicy, HashPolicy>::rebuildFilter() {
+    filter_.reset(filterCapacity(bucketCount()), filterBitsPerKey_);
+    for (size_t slot = 0; slot < slotCount(); ++slot) {
+        for (quint32 i = slotHead(slot); i != kNil; i = nodes_[i].next) {
+            filter_.insert(nodes_[i].hash);
+        }
+    }
+    filterStale_ = 0;
+}
+
+template <typename TracePolicy, typename IndexPolicy, typename HashPolicy>
+bool BasicHashMap<TracePolicy, IndexPolicy, HashPolicy>::filterRejects(size_t hash) {
+    if (!filterEnabled_ || filter_.mayContain(hash)) return false;
+    trace_.add(HashStepOp::FilterAbsent, [&](HashStep &s) { s.hash = hash; });
+    return true;
+}
+
+template <typename TracePolicy, typename IndexPolicy, typename HashPolicy>
+void BasicHashMap<TracePolicy, IndexPolicy, HashPolicy>::filterAdded(size_t hash) {
+    if (!filterEnabled_) return;
+    // filter_ keeps answering for the whole map until a migration ends;
+    // nextFilter_ needs the key only if it skipped the old table.
+    filter_.insert(hash);
+    if (!oldHeads_.empty() && inCurrentTable(hash)) nextFilter_.insert(hash);
+}
+
+template <typename TracePolicy, typename IndexPolicy, typename HashPolicy>
+void BasicHashMap<TracePolicy, IndexPolicy, HashPolicy>::filterRemoved(size_t hash) {
+    if (!filterEnabled_) return;
+    ++filterStale_;
+    // A key still in the old table never reaches nextFilter_.
+    if (!oldHeads_.empty() && inCurrentTable(hash)) ++nextFilterStale_;
+    if (oldHeads_.empty() && filterStale_ > std::max(64, numElements_ / 2)) rebuildFilter();
+}
+
+template <typename TracePolicy, typename IndexPolicy, typename HashPolicy>
+void BasicHashMap<TracePolicy, IndexPolicy, HashPolicy>::setIncrementalRehash(bool enabled, int bucketsPerOperation) {
+    if (!enabled) finishMigration();
+    incrementalRehash_ = enabled;
+    migrateBucketsPerOp_ = std::max(1, bucketsPerOperation);
+}
+
+template <typename TracePolicy, typename IndexPolicy, typename HashPolicy>
+bool BasicHashMap<TracePolicy, IndexPolicy, HashPolicy>::isRehashing() const {
+    return !oldHeads_.empty();
+}
+
+template <typename TracePolicy, typename IndexPolicy, typename HashPolicy>
+quint32 &BasicHashMap<TracePolicy, IndexPolicy, HashPolicy>::locateChain(size_t hash, int &index) {
+    // During migration a key lives in the old table until its old bucket
+    // has been moved, so exactly one chain ever needs to be searched.
+    if (!oldHeads_.empty()) {
+        const int oldCount = static_cast<int>(oldHeads_.size());
+        const int oldIndex = oldIndex_.index(hash);
+        if (static_cast<size_t>(oldIndex) >= migrateCursor_) {
+            index = oldIndex;
+            trace_.add(IndexPolicy::traceOp, [&](HashStep &s) { s.count = oldCount; s.bucket = oldIndex; });
+            trace_.add(HashStepOp::VisitOldBucket, [&](HashStep &s) { s.bucket = oldIndex; });
+            return oldHeads_[static_cast<size_t>(oldIndex)];
+        }
+    }
+
     const int bucketCountNow = bucketCount();
-    const size_t hash = static_cast<size_t>(qHash(key));
-    const int index = static_cast<int>(hash % static_cast<size_t>(bucketCountNow));
-
-    addStep(QStringLiteral("Compute hash(%1) = %2").arg(key).arg(static_cast<qulonglong>(hash)));
-    addStep(QStringLiteral("Index = hash %% %1 = %2").arg(bucketCountNow).arg(index));
-    addStep(QStringLiteral("Visit bucket %1").arg(index));
-
-    auto &chain = buckets_[static_cast<size_t>(index)];
-    for (auto &node : chain) {
-        addStep(QStringLiteral("Compare keys: %1 == %2 ? %3")
-                    .arg(node.key, key, node.key == key ? QStringLiteral("Yes") : QStringLiteral("No")));
-        if (node.key == key) {
+    index = index_.index(hash);
+    trace_.add(IndexPolicy::traceOp, [&](HashStep &s) { s.count = bucketCountNow; s.bucket = index; });
+    trace_.add(HashStepOp::VisitBucket, [&](HashStep &s) { s.bucket = index; });
+    return heads_[static_cast<size_t>(index)];
+}
+
+template <typename TracePolicy, typename IndexPolicy, typename HashPolicy>
+bool BasicHashMap<TracePolicy, IndexPolicy, HashPolicy>::keyMatches(const Node &node, size_t hash, QStringView key, int keyRef) {
+    // The cached hash rejects almost every non-matching node without
+    // touching its key.
+    if (node.hash != hash) {
+        trace_.add(HashStepOp::HashMismatch, [&](HashStep &s) {
+            s.keyRef = trace_.ref(node.key);
+            s.hash = node.hash;
+        });
+        return false;
+    }
+    const bool matched = node.key == key;
+    trace_.add(HashStepOp::CompareKeys, [&](HashStep &s) {
+        s.keyRef = trace_.ref(node.key);
+        s.otherRef = keyRef;
+        s.matched = matched;
+    });
+    return matched;
+}
+
+template <typename TracePolicy, typename IndexPolicy, typename HashPolicy>
+void BasicHashMap<TracePolicy, IndexPolicy, HashPolicy>::relinkChain(quint32 head) {
+    quint32 i = head;
+    while (i != kNil) {
+        Node &node = nodes_[i];
+        const quint32 next = node.next;
+        const int newIndex = index_.index(node.hash);
+        trace_.add(HashStepOp::MoveNode, [&](HashStep &s) {
+            s.keyRef = trace_.ref(node.key);
+            s.otherRef = trace_.ref(node.value);
+            s.bucket = newIndex;
+        });
+        node.next = heads_[static_cast<size_t>(newIndex)];
+        heads_[static_cast<size_t>(newIndex)] = i;
+        countAdded(newIndex);
+        if (filterEnabled_ && !oldHeads_.empty()) nextFilter_.insert(node.hash);
+        if (metrics_) metrics_->countMove();
+        i = next;
+    }
+}
+
+template <typename TracePolicy, typename IndexPolicy, typename HashPolicy>
+void BasicHashMap<TracePolicy, IndexPolicy, HashPolicy>::advanceMigration() {
+    if (oldHeads_.empty()) return;
+    QElapsedTimer timer;
+    if (metrics_) timer.start();
+    const size_t end = std::min(oldHeads_.size(), migrateCursor_ + static_cast<size_t>(migrateBucketsPerOp_));
+    for (; migrateCursor_ < end; ++migrateCursor_) {
+        relinkChain(oldHeads_[migrateCursor_]);
+    }
+    if (metrics_) metrics_->countRehashTime(static_cast<quint64>(timer.nsecsElapsed()));
+    trace_.add(HashStepOp::MigrateBuckets, [&](HashStep &s) {
+        s.bucket = static_cast<int>(migrateCursor_);
+        s.count = static_cast<int>(oldHeads_.size());
+    });
+    if (migrateCursor_ == oldHeads_.size()) {
+        std::vector<quint32>().swap(oldHeads_);
+        migrateCursor_ = 0;
+        if (filterEnabled_) {
+            filter_ = std::move(nextFilter_);
+            filterStale_ = nextFilterStale_;
+        }
+        nextFilter_ = BlockedBloomFilter();
+        nextFilterStale_ = 0;
+        trace_.add(HashStepOp::MigrateDone);
+    }
+}
+
+template <typename TracePolicy, typename IndexPolicy, typename HashPolicy>
+void BasicHashMap<TracePolicy, IndexPolicy, HashPolicy>::finishMigration() {
+    if (oldHeads_.empty()) return;
+    const int remaining = static_cast<int>(oldHeads_.size() - migrateCursor_);
+    const int saved = migrateBucketsPerOp_;
+    migrateBucketsPerOp_ = remaining;
+    advanceMigration();
+    migrateBucketsPerOp_ = saved;
+}
+
+template <typename TracePolicy, typename IndexPolicy, typename HashPolicy>
+quint32 BasicHashMap<TracePolicy, IndexPolicy, HashPolicy>::allocateNode(QString key, QString value, size_t hash) {
+    if (freeList_ != kNil) {
+        const quint32 index = freeList_;
+        Node &node = nodes_[index];
+        freeList_ = node.next;
+        node.key = std::move(key);
+        node.value = std::move(value);
+        node.hash = hash;
+        node.next = kNil;
+        return index;
+    }
+    nodes_.push_back(Node{std::move(key), std::move(value), hash, kNil});
+    return static_cast<quint32>(nodes_.size() - 1);
+}
+
+template <typename TracePolicy, typename IndexPolicy, typename HashPolicy>
+void BasicHashMap<TracePolicy, IndexPolicy, HashPolicy>::releaseNode(quint32 index) {
+    Node &node = nodes_[index];
+    node.key = QString();   // drop string payloads now, keep the slot
+    node.value = QString();
+    node.next = freeList_;
+    freeList_ = index;
+}
+
+template <typename TracePolicy, typename IndexPolicy, typename HashPolicy>
+std::pair<quint32, bool> BasicHashMap<TracePolicy, IndexPolicy, HashPolicy>::emplaceOrAssign(QString key, QString value, size_t hash, bool assignIfExists) {
+    const int keyRef = trace_.ref(key);
+    trace_.add(HashStepOp::ComputeHash, [&](HashStep &s) { s.hash = hash; s.keyRef = keyRef; });
+    // A key the filter rules out needs no duplicate check.
+    const bool absent = filterRejects(hash);
+    int index = 0;
+    quint32 &head = locateChain(hash, index);
+
+    for (quint32 i = absent ? kNil : head; i != kNil; i = nodes_[i].next) {
+        Node &node = nodes_[i];
+        if (keyMatches(node, hash, key, keyRef)) {
             if (assignIfExists) {
-                addStep(QStringLiteral("Key exists → update value: %1 → %2").arg(node.value, value));
-                node.value = value;
+                trace_.add(HashStepOp::UpdateValue, [&](HashStep &s) {
+                    s.keyRef = trace_.ref(node.value);
+                    s.otherRef = trace_.ref(value);
+                });
+                node.value = std::move(value);
             } else {
-                addStep(QStringLiteral("Key exists → no insert (duplicate)"));
+                trace_.add(HashStepOp::DuplicateKey);
             }
-            return false; // not a new insertion
+            return {i, false}; // not a new insertion
         }
-        addStep(QStringLiteral("Traverse next in chain"));
+        trace_.add(HashStepOp::TraverseNext);
     }
 
-    addStep(QStringLiteral("Append new node to bucket %1").arg(index));
-    chain.push_front(Node{key, value});
+    trace_.add(HashStepOp::AppendNode, [&](HashStep &s) { s.bucket = index; });
+    const quint32 fresh = allocateNode(std::move(key), std::move(value), hash);
+    nodes_[fresh].next = head;
+    head = fresh;
     ++numElements_;
-    addStep(QStringLiteral("New size = %1, load factor = %2")
-                .arg(numElements_)
-                .arg(loadFactor(), 0, 'f', 2));
-    return true;
+    if (inCurrentTable(hash)) countAdded(index);
+    filterAdded(hash);
+    trace_.add(HashStepOp::NewSize, [&](HashStep &s) {
+        s.count = numElements_;
+        s.loadFactor = loadFactor();
+    });
+    return {fresh, true};
+}
+
+template <typename TracePolicy, typename IndexPolicy, typename HashPolicy>
+bool BasicHashMap<TracePolicy, IndexPolicy, HashPolicy>::insert(const QString &key, const QString &value) {
+    return insert(key, value, HashPolicy::hash(key));
+}
+
+template <typename TracePolicy, typename IndexPolicy, typename HashPolicy>
+bool BasicHashMap<TracePolicy, IndexPolicy, HashPolicy>::insert(const QString &key, const QString &value, size_t hash) {
+    const HashMetricsRecorder::OperationTimer timer(metrics_.get(), HashOperation::Insert);
+    clearSteps();
+    maybeGrow();
+    advanceMigration();
+    return emplaceOrAssign(key, value, hash, /*assignIfExists=*/false).second;
 }
 
-bool HashMap::insert(const QString &key, const QString &value) {
+template <typename TracePolicy, typename IndexPolicy, typename HashPolicy>
+void BasicHashMap<TracePolicy, IndexPolicy, HashPolicy>::put(const QString &key, const QString &value) {
+    put(key, value, HashPolicy::hash(key));
+}
+
+template <typename TracePolicy, typename IndexPolicy, typename HashPolicy>
+void BasicHashMap<TracePolicy, IndexPolicy, HashPolicy>::put(const QString &key, const QString &value, size_t hash) {
+    const HashMetricsRecorder::OperationTimer timer(metrics_.get(), HashOperation::Put);
     clearSteps();
     maybeGrow();
-    return emplaceOrAssign(key, value, /*assignIfExists=*/false);
+    advanceMigration();
+    (void)emplaceOrAssign(key, value, hash, /*assignIfExists=*/true);
 }
 
-void HashMap::put(const QString &key, const QString &value) {
+template <typename TracePolicy, typename IndexPolicy, typename HashPolicy>
+std::pair<QString *, bool> BasicHashMap<TracePolicy, IndexPolicy, HashPolicy>::try_emplace(QString key, QString value) {
+    const HashMetricsRecorder::OperationTimer timer(metrics_.get(), HashOperation::Insert);
     clearSteps();
     maybeGrow();
-    (void)emplaceOrAssign(key, value, /*assignIfExists=*/true);
+    advanceMigration();
+    const size_t hash = HashPolicy::hash(key);
+    const auto [node, inserted] = emplaceOrAssign(std::move(key), std::move(value), hash, /*assignIfExists=*/false);
+    return {&nodes_[node].value, inserted};
 }
 
-std::optional<QString> HashMap::get(const QString &key) {
+template <typename TracePolicy, typename IndexPolicy, typename HashPolicy>
+std::pair<QString *, bool> BasicHashMap<TracePolicy, IndexPolicy, HashPolicy>::insert_or_assign(QString key, QString value) {
+    const HashMetricsRecorder::OperationTimer timer(metrics_.get(), HashOperation::Put);
     clearSteps();
-    if (buckets_.empty()) {
-        addStep(QStringLiteral("Table is empty → not found"));
+    maybeGrow();
+    advanceMigration();
+    const size_t hash = HashPolicy::hash(key);
+    const auto [node, inserted] = emplaceOrAssign(std::move(key), std::move(value), hash, /*assignIfExists=*/true);
+    return {&nodes_[node].value, inserted};
+}
+
+template <typename TracePolicy, typename IndexPolicy, typename HashPolicy>
+quint32 BasicHashMap<TracePolicy, IndexPolicy, HashPolicy>::findNode(QStringView key, size_t hash) const {
+    if (heads_.empty()) return kNil;
+    // Same chain choice as locateChain(), minus the trace.
+    if (filterEnabled_ && !filter_.mayContain(hash)) {
+        if (metrics_) metrics_->countLookup(/*hit=*/false, 0);
+        return kNil;
+    }
+    const quint32 *head = nullptr;
+    if (!oldHeads_.empty()) {
+        const size_t oldIndex = static_cast<size_t>(oldIndex_.index(hash));
+        if (oldIndex >= migrateCursor_) head = &oldHeads_[oldIndex];
+    }
+    if (!head) head = &heads_[static_cast<size_t>(index_.index(hash))];
+    quint64 visited = 0;
+    quint32 i = *head;
+    for (; i != kNil; i = nodes_[i].next) {
+        ++visited;
+        const Node &node = nodes_[i];
+        if (node.hash == hash && node.key == key) break;
+    }
+    if (metrics_) metrics_->countLookup(i != kNil, visited);
+    return i;
+}
+
+template <typename TracePolicy, typename IndexPolicy, typename HashPolicy>
+QString *BasicHashMap<TracePolicy, IndexPolicy, HashPolicy>::find(QStringView key) {
+    const HashMetricsRecorder::OperationTimer timer(metrics_.get(), HashOperation::Contains);
+    const quint32 i = findNode(key, HashPolicy::hash(key));
+    return i == kNil ? nullptr : &nodes_[i].value;
+}
+
+template <typename TracePolicy, typename IndexPolicy, typename HashPolicy>
+const QString *BasicHashMap<TracePolicy, IndexPolicy, HashPolicy>::find(QStringView key) const {
+    const HashMetricsRecorder::OperationTimer timer(metrics_.get(), HashOperation::Contains);
+    const quint32 i = findNode(key, HashPolicy::hash(key));
+    return i == kNil ? nullptr : &nodes_[i].value;
+}
+
+template <typename TracePolicy, typename IndexPolicy, typename HashPolicy>
+std::optional<QString> BasicHashMap<TracePolicy, IndexPolicy, HashPolicy>::get(QStringView key) {
+    return get(key, HashPolicy::hash(key));
+}
+
+template <typename TracePolicy, typename IndexPolicy, typename HashPolicy>
+std::optional<QString> BasicHashMap<TracePolicy, IndexPolicy, HashPolicy>::get(QStringView key, size_t hash) {
+    const HashMetricsRecorder::OperationTimer timer(metrics_.get(), HashOperation::Get);
+    clearSteps();
+    if (heads_.empty()) {
+        trace_.add(HashStepOp::TableEmpty);
         return std::nullopt;
     }
+    advanceMigration();
 
-    const int bucketCountNow = bucketCount();
-    const size_t hash = static_cast<size_t>(qHash(key));
-    const int index = static_cast<int>(hash % static_cast<size_t>(bucketCountNow));
-
-    addStep(QStringLiteral("Compute hash(%1) = %2").arg(key).arg(static_cast<qulonglong>(hash)));
-    addStep(QStringLiteral("Index = hash %% %1 = %2").arg(bucketCountNow).arg(index));
-    addStep(QStringLiteral("Visit bucket %1").arg(index));
-
-    const auto &chain = buckets_[static_cast<size_t>(index)];
-    for (const auto &node : chain) {
-        addStep(QStringLiteral("Compare keys: %1 == %2 ? %3")
-                    .arg(node.key, key, node.key == key ? QStringLiteral("Yes") : QStringLiteral("No")));
-        if (node.key == key) {
-            addStep(QStringLiteral("Found → return value %1").arg(node.value));
+    const int keyRef = trace_.ref(key);
+    trace_.add(HashStepOp::ComputeHash, [&](HashStep &s) { s.hash = hash; s.keyRef = keyRef; });
+    if (filterRejects(hash)) {
+        if (metrics_) metrics_->countLookup(/*hit=*/false, 0);
+        return std::nullopt;
+    }
+    int index = 0;
+    quint32 &head = locateChain(hash, index);
+
+    quint64 visited = 0;
+    for (quint32 i = head; i != kNil; i = nodes_[i].next) {
+        ++visited;
+        const Node &node = nodes_[i];
+        if (keyMatches(node, hash, key, keyRef)) {
+            trace_.add(HashStepOp::Found, [&](HashStep &s) { s.keyRef = trace_.ref(node.value); });
+            if (metrics_) metrics_->countLookup(/*hit=*/true, visited);
             return node.value;
         }
-        addStep(QStringLiteral("Traverse next in chain"));
+        trace_.add(HashStepOp::TraverseNext);
     }
-    addStep(QStringLiteral("Reached end of chain → not found"));
+    trace_.add(HashStepOp::NotFound);
+    if (metrics_) metrics_->countLookup(/*hit=*/false, visited);
     return std::nullopt;
 }
 
-bool HashMap::erase(const QString &key) {
+template <typename TracePolicy, typename IndexPolicy, typename HashPolicy>
+std::optional<QString> BasicHashMap<TracePolicy, IndexPolicy, HashPolicy>::get(QLatin1StringView key) {
+    KeyBuffer buffer;
+    return get(decodeKey(key, buffer));
+}
+
+template <typename TracePolicy, typename IndexPolicy, typename HashPolicy>
+std::optional<QString> BasicHashMap<TracePolicy, IndexPolicy, HashPolicy>::get(QUtf8StringView key) {
+    KeyBuffer buffer;
+    return get(decodeKey(key, buffer));
+}
+
+template <typename TracePolicy, typename IndexPolicy, typename HashPolicy>
+bool BasicHashMap<TracePolicy, IndexPolicy, HashPolicy>::erase(QStringView key) {
+    return erase(key, HashPolicy::hash(key));
+}
+
+template <typename TracePolicy, typename IndexPolicy, typename HashPolicy>
+bool BasicHashMap<TracePolicy, IndexPolicy, HashPolicy>::erase(QStringView key, size_t hash) {
+    const HashMetricsRecorder::OperationTimer timer(metrics_.get(), HashOperation::Erase);
     clearSteps();
-    if (buckets_.empty()) {
-        addStep(QStringLiteral("Table is empty → nothing to erase"));
+    if (heads_.empty()) {
+        trace_.add(HashStepOp::EraseEmpty);
         return false;
     }
+    advanceMigration();
 
-    const int bucketCountNow = bucketCount();
-    const size_t hash = static_cast<size_t>(qHash(key));
-    const int index = static_cast<int>(hash % static_cast<size_t>(bucketCountNow));
-
-    addStep(QStringLiteral("Compute hash(%1) = %2").arg(key).arg(static_cast<qulonglong>(hash)));
-    addStep(QStringLiteral("Index = hash %% %1 = %2").arg(bucketCountNow).arg(index));
-    addStep(QStringLiteral("Visit bucket %1").arg(index));
-
-    auto &chain = buckets_[static_cast<size_t>(index)];
-    auto before = chain.before_begin();
-    for (auto it = chain.begin(); it != chain.end(); ++it) {
-        addStep(QStringLiteral("Compare keys: %1 == %2 ? %3")
-                    .arg(it->key, key, it->key == key ? QStringLiteral("Yes") : QStringLiteral("No")));
-        if (it->key == key) {
-            chain.erase_after(before);
+    const int keyRef = trace_.ref(key);
+    trace_.add(HashStepOp::ComputeHash, [&](HashStep &s) { s.hash = hash; s.keyRef = keyRef; });
+    if (filterRejects(hash)) return false;
+    int index = 0;
+    quint32 &head = locateChain(hash, index);
+
+    // `link` is the index slot pointing at the current node, so unlinking is
+    // a single store whether the node is the chain head or not.
+    quint32 *link = &head;
+    while (*link != kNil) {
+        const quint32 i = *link;
+        if (keyMatches(nodes_[i], hash, key, keyRef)) {
+            *link = nodes_[i].next;
+            releaseNode(i);
             --numElements_;
-            addStep(QStringLiteral("Erased node. New size = %1, load factor = %2")
-                        .arg(numElements_)
-                        .arg(loadFactor(), 0, 'f', 2));
+            if (inCurrentTable(hash)) countRemoved(index);
+            trace_.add(HashStepOp::Erased, [&](HashStep &s) {
+                s.count = numElements_;
+                s.loadFactor = loadFactor();
+            });
+            // Before maybeShrink(): a synchronous shrink rebuilds the filter
+            // without this key, and the count must not outlive that.
+            filterRemoved(hash);
+            maybeShrink();
             return true;
         }
-        ++before;
-        addStep(QStringLiteral("Traverse next in chain"));
+        link = &nodes_[i].next;
+        trace_.add(HashStepOp::TraverseNext);
     }
-    addStep(QStringLiteral("Reached end of chain → key not found"));
+    trace_.add(HashStepOp::EraseNotFound);
     return false;
 }
 
-bool HashMap::contains(const QString &key) {
-    return get(key).has_value();
+template <typename TracePolicy, typename IndexPolicy, typename HashPolicy>
+bool BasicHashMap<TracePolicy, IndexPolicy, HashPolicy>::erase(QLatin1StringView key) {
+    KeyBuffer buffer;
+    return erase(decodeKey(key, buffer));
+}
+
+template <typename TracePolicy, typename IndexPolicy, typename HashPolicy>
+bool BasicHashMap<TracePolicy, IndexPolicy, HashPolicy>::erase(QUtf8StringView key) {
+    KeyBuffer buffer;
+    return erase(decodeKey(key, buffer));
+}
+
+template <typename TracePolicy, typename IndexPolicy, typename HashPolicy>
+bool BasicHashMap<TracePolicy, IndexPolicy, HashPolicy>::contains(QStringView key) const {
+    return contains(key, HashPolicy::hash(key));
+}
+
+template <typename TracePolicy, typename IndexPolicy, typename HashPolicy>
+bool BasicHashMap<TracePolicy, IndexPolicy, HashPolicy>::contains(QStringView key, size_t hash) const {
+    const HashMetricsRecorder::OperationTimer timer(metrics_.get(), HashOperation::Contains);
+    return findNode(key, hash) != kNil;
+}
+
+template <typename TracePolicy, typename IndexPolicy, typename HashPolicy>
+bool BasicHashMap<TracePolicy, IndexPolicy, HashPolicy>::contains(QLatin1StringView key) const {
+    KeyBuffer buffer;
+    return contains(decodeKey(key, buffer));
+}
+
+template <typename TracePolicy, typename IndexPolicy, typename HashPolicy>
+bool BasicHashMap<TracePolicy, IndexPolicy, HashPolicy>::contains(QUtf8StringView key) const {
+    KeyBuffer buffer;
+    return contains(decodeKey(key, buffer));
 }
 
-void HashMap::clear() {
+template <typename TracePolicy, typename IndexPolicy, typename HashPolicy>
+void BasicHashMap<TracePolicy, IndexPolicy, HashPolicy>::clear(bool releaseStorage) {
     clearSteps();
-    for (auto &chain : buckets_) {
-        chain.clear();
+    if (releaseStorage) {
+        std::vector<Node>().swap(nodes_);
+        std::vector<quint32>().swap(heads_);
+        resetBuckets(minBucketCount_);
+    } else {
+        nodes_.clear();
+        std::fill(heads_.begin(), heads_.end(), kNil);
     }
+    std::vector<quint32>().swap(oldHeads_);
+    migrateCursor_ = 0;
+    freeList_ = kNil;
     numElements_ = 0;
-    addStep(QStringLiteral("Cleared all buckets"));
-}
-
-void HashMap::rehash(int newBucketCount) {
-    if (newBucketCount < 1) newBucketCount = 1;
-    QVector<QString> rehashSteps;
-    rehashSteps.push_back(QStringLiteral("Rehashing to %1 buckets").arg(newBucketCount));
-
-    std::vector<std::forward_list<Node>> newBuckets(static_cast<size_t>(newBucketCount));
-    for (auto &chain : buckets_) {
-        for (auto &node : chain) {
-            const int newIndex = indexFor(node.key, newBucketCount);
-            rehashSteps.push_back(QStringLiteral("Move (%1,%2) → bucket %3")
-                                      .arg(node.key, node.value)
-                                      .arg(newIndex));
-            newBuckets[static_cast<size_t>(newIndex)].push_front(Node{std::move(node.key), std::move(node.value)});
-        }
+    resetOccupancy();
+    nextFilter_ = BlockedBloomFilter();
+    nextFilterStale_ = 0;
+    if (filterEnabled_) rebuildFilter();
+    trace_.add(HashStepOp::Cleared);
+}
+
+template <typename TracePolicy, typename IndexPolicy, typename HashPolicy>
+void BasicHashMap<TracePolicy, IndexPolicy, HashPolicy>::rehash(int newBucketCount) {
+    newBucketCount = IndexPolicy::roundBucketCount(std::max(1, newBucketCount));
+    trace_.add(HashStepOp::Rehashing, [&](HashStep &s) {
+        s.count = bucketCount();
+        s.bucket = newBucketCount;
+    });
+
+    finishMigration();
+    QElapsedTimer timer;
+    if (metrics_) {
+        metrics_->countRehash();
+        timer.start();
     }
-    buckets_.swap(newBuckets);
-    // Append rehash steps to the live steps log.
-    for (const auto &s : rehashSteps) lastSteps_.push_back(s);
+
+    // Nodes stay where they are; only the bucket heads are rebuilt and each
+    // node is relinked into its new chain.
+    std::vector<quint32> oldHeads;
+    oldHeads.swap(heads_);
+    resetBuckets(newBucketCount);
+    for (quint32 head : oldHeads) {
+        relinkChain(head);
+    }
+    if (filterEnabled_) rebuildFilter();
+    if (metrics_) metrics_->countRehashTime(static_cast<quint64>(timer.nsecsElapsed()));
+}
+
+template <typename TracePolicy, typename IndexPolicy, typename HashPolicy>
+int BasicHashMap<TracePolicy, IndexPolicy, HashPolicy>::reservedBucketCount(int expectedElements) const {
+    const float desiredLoad = std::min(0.6f, maxLoadFactor_); // target below max for headroom
+    return IndexPolicy::roundBucketCount(std::max(1, static_cast<int>(expectedElements / desiredLoad)));
 }
 
-void HashMap::reserve(int expectedElements) {
+template <typename TracePolicy, typename IndexPolicy, typename HashPolicy>
+void BasicHashMap<TracePolicy, IndexPolicy, HashPolicy>::reserve(int expectedElements) {
     if (expectedElements <= 0) return;
-    const float desiredLoad = 0.6f; // target below max for headroom
-    const int requiredBuckets = std::max(1, static_cast<int>(expectedElements / desiredLoad));
+    const int requiredBuckets = reservedBucketCount(expectedElements);
     if (requiredBuckets > bucketCount()) {
-        addStep(QStringLiteral("Reserve(%1) → rehash to %2 buckets")
-                    .arg(expectedElements)
-                    .arg(requiredBuckets));
+        trace_.add(HashStepOp::ReserveRehash, [&](HashStep &s) {
+            s.count = expectedElements;
+            s.bucket = requiredBuckets;
+        });
         rehash(requiredBuckets);
     }
+    nodes_.reserve(static_cast<size_t>(expectedElements));
+}
+
+template <typename TracePolicy, typename IndexPolicy, typename HashPolicy>
+void BasicHashMap<TracePolicy, IndexPolicy, HashPolicy>::shrink_to_fit() {
+    finishMigration();
+    QElapsedTimer timer;
+    if (metrics_) {
+        metrics_->countRehash();
+        timer.start();
+    }
+
+    // Copy live nodes, chain by chain, into exactly-sized storage; the
+    // rehash below relinks them from a single chain threaded through all.
+    std::vector<Node> packed;
+    packed.reserve(static_cast<size_t>(numElements_));
+    for (quint32 head : heads_) {
+        for (quint32 i = head; i != kNil; i = nodes_[i].next) {
+            Node &node = nodes_[i];
+            packed.push_back(Node{std::move(node.key), std::move(node.value), node.hash,
+                                  static_cast<quint32>(packed.size() + 1)});
+        }
+    }
+    if (!packed.empty()) packed.back().next = kNil;
+    nodes_.swap(packed);
+    freeList_ = kNil;
+
+    const int newCount = std::min(std::max(minBucketCount_, reservedBucketCount(numElements_)), bucketCount());
+    trace_.add(HashStepOp::Rehashing, [&](HashStep &s) {
+        s.count = bucketCount();
+        s.bucket = newCount;
+    });
+    resetBuckets(newCount);
+    relinkChain(nodes_.empty() ? kNil : 0);
+    if (filterEnabled_) rebuildFilter();
+    if (metrics_) metrics_->countRehashTime(static_cast<quint64>(timer.nsecsElapsed()));
+}
+
+template <typename TracePolicy, typename IndexPolicy, typename HashPolicy>
+size_t BasicHashMap<TracePolicy, IndexPolicy, HashPolicy>::slotCount() const {
+    return heads_.size() + (oldHeads_.size() - std::min(migrateCursor_, oldHeads_.size()));
+}
+
+template <typename TracePolicy, typename IndexPolicy, typename HashPolicy>
+quint32 BasicHashMap<TracePolicy, IndexPolicy, HashPolicy>::slotHead(size_t slot) const {
+    if (slot < heads_.size()) return heads_[slot];
+    return oldHeads_[migrateCursor_ + (slot - heads_.size())];
+}
+
+template <typename TracePolicy, typename IndexPolicy, typename HashPolicy>
+typename BasicHashMap<TracePolicy, IndexPolicy, HashPolicy>::iterator BasicHashMap<TracePolicy, IndexPolicy, HashPolicy>::begin() {
+    return iterator(this, 0, slotCount());
+}
+
+template <typename TracePolicy, typename IndexPolicy, typename HashPolicy>
+typename BasicHashMap<TracePolicy, IndexPolicy, HashPolicy>::iterator BasicHashMap<TracePolicy, IndexPolicy, HashPolicy>::end() {
+    return iterator(this, slotCount(), slotCount());
+}
+
+template <typename TracePolicy, typename IndexPolicy, typename HashPolicy>
+typename BasicHashMap<TracePolicy, IndexPolicy, HashPolicy>::const_iterator BasicHashMap<TracePolicy, IndexPolicy, HashPolicy>::begin() const {
+    return const_iterator(this, 0, slotCount());
 }
 
-QVector<int> HashMap::bucketSizes() const {
-    QVector<int> sizes;
-    sizes.reserve(static_cast<int>(buckets_.size()));
-    for (const auto &chain : buckets_) {
-        int count = 0;
-        for (const auto &n : chain) {
-            (void)n; // suppress unused variable warning
-            ++count;
+template <typename TracePolicy, typename IndexPolicy, typename HashPolicy>
+typename BasicHashMap<TracePolicy, IndexPolicy, HashPolicy>::const_iterator BasicHashMap<TracePolicy, IndexPolicy, HashPolicy>::end() const {
+    return const_iterator(this, slotCount(), slotCount());
+}
+
+template <typename TracePolicy, typename IndexPolicy, typename HashPolicy>
+typename BasicHashMap<TracePolicy, IndexPolicy, HashPolicy>::BucketRange BasicHashMap<TracePolicy, IndexPolicy, HashPolicy>::bucketRange(int first, int last) const {
+    const size_t end = std::min(static_cast<size_t>(std::max(0, last)), heads_.size());
+    const size_t begin = std::min(static_cast<size_t>(std::max(0, first)), end);
+    return BucketRange{const_iterator(this, begin, end), const_iterator(this, end, end)};
+}
+
+template <typename TracePolicy, typename IndexPolicy, typename HashPolicy>
+bool BasicHashMap<TracePolicy, IndexPolicy, HashPolicy>::saveSnapshot(const QString &path, QString *errorString) const {
+    using SnapshotHash = std::conditional_t<HashPolicy::seeded, XxHash3, HashPolicy>;
+    SnapshotWriter writer(SnapshotHash::name, numElements_);
+    const auto addChain = [&](quint32 head) {
+        for (quint32 i = head; i != kNil; i = nodes_[i].next) {
+            const Node &node = nodes_[i];
+            const size_t hash = HashPolicy::seeded ? SnapshotHash::hash(node.key) : node.hash;
+            writer.add(node.key, node.value, static_cast<quint64>(hash));
+        }
+    };
+    for (quint32 head : heads_) addChain(head);
+    for (size_t b = migrateCursor_; b < oldHeads_.size(); ++b) addChain(oldHeads_[b]);
+    return writer.write(path, errorString);
+}
+
+template <typename TracePolicy, typename IndexPolicy, typename HashPolicy>
+QVector<int> BasicHashMap<TracePolicy, IndexPolicy, HashPolicy>::bucketSizes() const {
+    if (oldHeads_.empty()) return bucketSizes_;
+    // Entries waiting in old buckets [migrateCursor_, end) are not in the
+    // maintained counts yet; add them under their destination bucket.
+    QVector<int> sizes = bucketSizes_;
+    for (size_t b = migrateCursor_; b < oldHeads_.size(); ++b) {
+        for (quint32 i = oldHeads_[b]; i != kNil; i = nodes_[i].next) {
+            ++sizes[index_.index(nodes_[i].hash)];
         }
-        sizes.push_back(count);
     }
     return sizes;
 }
 
+template <typename TracePolicy, typename IndexPolicy, typename HashPolicy>
+QVector<int> BasicHashMap<TracePolicy, IndexPolicy, HashPolicy>::chainLengthHistogram() const {
+    if (oldHeads_.empty()) return chainHistogram_;
+    QVector<int> histogram(1, 0);
+    for (int length : bucketSizes()) {
+        if (length >= histogram.size()) histogram.resize(length + 1);
+        ++histogram[length];
+    }
+    return histogram;
+}
+
+template <typename TracePolicy, typename IndexPolicy, typename HashPolicy>
+int BasicHashMap<TracePolicy, IndexPolicy, HashPolicy>::longestChain() const {
+    if (oldHeads_.empty()) return longestChain_;
+    const QVector<int> sizes = bucketSizes();
+    return sizes.isEmpty() ? 0 : *std::max_element(sizes.cbegin(), sizes.cend());
+}
+
+template <typename TracePolicy, typename IndexPolicy, typename HashPolicy>
+void BasicHashMap<TracePolicy, IndexPolicy, HashPolicy>::setMetricsEnabled(bool enabled, int sampleEvery) {
+    if (enabled) {
+        metrics_ = std::make_unique<HashMetricsRecorder>(sampleEvery);
+    } else {
+        metrics_.reset();
+    }
+}
+
+template <typename TracePolicy, typename IndexPolicy, typename HashPolicy>
+bool BasicHashMap<TracePolicy, IndexPolicy, HashPolicy>::metricsEnabled() const {
+    return metrics_ != nullptr;
+}
+
+template <typename TracePolicy, typename IndexPolicy, typename HashPolicy>
+HashMapMetrics BasicHashMap<TracePolicy, IndexPolicy, HashPolicy>::metrics() const {
+    return metrics_ ? metrics_->snapshot() : HashMapMetrics();
+}
+
+template <typename TracePolicy, typename IndexPolicy, typename HashPolicy>
+void BasicHashMap<TracePolicy, IndexPolicy, HashPolicy>::resetMetrics() {
+    if (metrics_) metrics_->reset();
+}
 
+template class BasicHashMap<StepTrace, ModuloIndex>;
+template class BasicHashMap<StepTrace, PowerOfTwoIndex>;
+template class BasicHashMap<StepTrace, PrimeIndex>;
+template class BasicHashMap<StepTrace, FastRangeIndex>;
+template class BasicHashMap<NoTrace, ModuloIndex>;
+template class BasicHashMap<NoTrace, PowerOfTwoIndex>;
+template class BasicHashMap<NoTrace, PrimeIndex>;
+template class BasicHashMap<NoTrace, FastRangeIndex>;
+template class BasicHashMap<StepTrace, ModuloIndex, WyHash>;
+template class BasicHashMap<StepTrace, ModuloIndex, XxHash3>;
+template class BasicHashMap<StepTrace, ModuloIndex, Fnv1aHash>;
+template class BasicHashMap<NoTrace, ModuloIndex, WyHash>;
+template class BasicHashMap<NoTrace, ModuloIndex, XxHash3>;
+template class BasicHashMap<NoTrace, ModuloIndex, Fnv1aHash>;
@@ -1,17 +1,40 @@
 #pragma once
 
 #include <QString>
+#include <QStringView>
+#include <QLatin1StringView>
+#include <QUtf8StringView>
 #include <QVector>
 #include <QHashFunctions>
-#include <forward_list>
+#include "bloomfilter.h"
+#include "hashfunctions.h"
+#include "hashindex.h"
+#include "hashmetrics.h"
+#include "hashstep.h"
+#include "parallelfor.h"
+#include <cstddef>
+#include <iterator>
+#include <memory>
 #include <optional>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 // Open-chaining HashMap specialized for QString keys and values.
-// Instrumented with a human-readable step trace for visualization.
-class HashMap {
+// Chains are stored flat: all nodes live in one contiguous array linked by
+// 32-bit indices, with erased nodes recycled through a free list. Each node
+// caches its full hash, so rehashing never rehashes keys and chain walks
+// skip nodes with a different hash without comparing strings.
+// HashPolicy (see hashfunctions.h) hashes keys; IndexPolicy (see
+// hashindex.h) maps hashes to buckets and decides which bucket counts are
+// allowed. Growth can optionally be incremental: the old and new bucket
+// arrays are kept side by side and every operation migrates a bounded
+// number of old buckets.
+// Instrumented with a step trace for visualization when TracePolicy enables it.
+template <typename TracePolicy, typename IndexPolicy = ModuloIndex, typename HashPolicy = QtHash>
+class BasicHashMap {
 public:
-    explicit HashMap(int initialBucketCount = 16, float maxLoadFactor = 0.75f);
+    explicit BasicHashMap(int initialBucketCount = 16, float maxLoadFactor = 0.75f);
 
     // Inserts a new key/value. Returns true if a new element was inserted,
     // false if an existing key was updated (no size change).
@@ -20,49 +43,416 @@ public:
     // Upsert variant: always assigns value (inserts if missing, updates if present).
     void put(const QString &key, const QString &value);
 
+    // Bulk variants over a range of key/value pairs (std::pair, QPair, ...).
+    // Forward ranges are presized once through reserve(), so the load runs
+    // without intermediate rehashes; wrap the range in move iterators to
+    // steal the strings. The trace holds a single summary instead of
+    // per-element steps. insertRange returns the number of new keys.
+    template <typename InputIt>
+    int insertRange(InputIt first, InputIt last) {
+        return loadRange(first, last, /*assignIfExists=*/false);
+    }
+
+    template <typename InputIt>
+    void putRange(InputIt first, InputIt last) {
+        (void)loadRange(first, last, /*assignIfExists=*/true);
+    }
+
     // Looks up a key and returns the value if found.
     // This method records a detailed step trace for UI display.
-    std::optional<QString> get(const QString &key);
+    // Lookups take views: QString converts implicitly, and Latin-1/UTF-8
+    // keys are decoded into a stack buffer, so probing never allocates.
+    std::optional<QString> get(QStringView key);
+    std::optional<QString> get(QLatin1StringView key);
+    std::optional<QString> get(QUtf8StringView key);
 
     // Erases a key if present. Returns true if something was removed.
-    bool erase(const QString &key);
+    bool erase(QStringView key);
+    bool erase(QLatin1StringView key);
+    bool erase(QUtf8StringView key);
+
+    // Membership test without tracing or copying the value.
+    bool contains(QStringView key) const;
+    bool contains(QLatin1StringView key) const;
+    bool contains(QUtf8StringView key) const;
+
+    // Hot-loop lookup: no step trace and no value copy. Returns nullptr if
+    // the key is absent. The pointer stays valid until the next insertion
+    // or until the key is erased.
+    QString *find(QStringView key);
+    const QString *find(QStringView key) const;
+
+    // Prehashed variants for wrappers that already hashed the key to route
+    // it (see ConcurrentHashMap), so it is not hashed a second time. hash
+    // must equal HashPolicy::hash(key).
+    bool insert(const QString &key, const QString &value, size_t hash);
+    void put(const QString &key, const QString &value, size_t hash);
+    std::optional<QString> get(QStringView key, size_t hash);
+    bool erase(QStringView key, size_t hash);
+    bool contains(QStringView key, size_t hash) const;
+
+    // std::unordered_map-style upserts. Keys and values are sink parameters,
+    // so rvalue arguments are moved into the node. Both return the stored
+    // value and whether a new key was inserted. try_emplace leaves an
+    // existing value untouched; insert_or_assign overwrites it.
+    std::pair<QString *, bool> try_emplace(QString key, QString value);
+    std::pair<QString *, bool> insert_or_assign(QString key, QString value);
+
+    // Forward iteration in bucket order, QHash style: *it and it.value()
+    // are the value, it.key() the key. Any non-const call invalidates
+    // iterators, get() included, since it can advance an incremental rehash.
+    template <bool Const>
+    class IteratorBase;
+    using iterator = IteratorBase<false>;
+    using const_iterator = IteratorBase<true>;
+
+    struct BucketRange {
+        const_iterator first;
+        const_iterator last;
+        const_iterator begin() const { return first; }
+        const_iterator end() const { return last; }
+    };
+
+    iterator begin();
+    iterator end();
+    const_iterator begin() const;
+    const_iterator end() const;
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+
+    // Entries of buckets [first, last) of the current bucket array. During
+    // an incremental migration, entries still in the old array are reached
+    // only through begin()/end().
+    BucketRange bucketRange(int first, int last) const;
+    BucketRange bucket(int index) const { return bucketRange(index, index + 1); }
+
+    // Splits the buckets (old and new during a migration) into chunks run
+    // on the global thread pool and the calling thread. f(key, value) and
+    // mapFn run concurrently and must not modify the map.
+    template <typename Function>
+    void parallelForEach(Function f) const;
 
-    bool contains(const QString &key);
+    // Maps each entry with mapFn(key, value) -> T and folds with
+    // reduceFn(T, T) -> T. Every chunk starts from identity, so it must be a
+    // true identity for reduceFn (0 for a sum). Chunk results are combined
+    // in bucket order: reduceFn must be associative but need not commute.
+    template <typename T, typename MapFunction, typename ReduceFunction>
+    T parallelReduce(T identity, MapFunction mapFn, ReduceFunction reduceFn) const;
 
-    void clear();
+    // Removes every entry. The bucket array and node storage are kept for
+    // reuse unless releaseStorage is set, which drops both and returns to
+    // the initial bucket count.
+    void clear(bool releaseStorage = false);
 
     int size() const;
     int bucketCount() const;
     float loadFactor() const;
 
+    // Explicit rehash/reserve always complete immediately (finishing any
+    // incremental migration first).
     void rehash(int newBucketCount);
     void reserve(int expectedElements);
 
-    // Visualization helpers
-    const QVector<QString> &lastSteps() const;
+    // Gives back memory after heavy erasing: the bucket array is resized to
+    // the count reserve(size()) would pick, but never below the initial
+    // count and never above the current one, so a well-loaded map keeps
+    // its buckets. Live nodes are packed to the front of node storage and
+    // the free list is dropped. Pointers returned by find() are invalidated.
+    void shrink_to_fit();
+
+    // Erase shrinks the bucket array once the load factor falls below
+    // minLoadFactor, resizing to the midpoint between the two thresholds so
+    // a map hovering near either one does not flip-flop. 0 disables
+    // shrinking; values are capped at a quarter of the maximum load factor.
+    void setMinLoadFactor(float minLoadFactor);
+    float minLoadFactor() const;
+
+    // Optional split-block Bloom filter (see bloomfilter.h) consulted before
+    // any bucket is touched, so most lookups of absent keys end after
+    // hashing. It is sized for the keys the bucket array holds before its
+    // next growth and rebuilt whenever the map rehashes (reserve() and
+    // shrinking included). Erased keys leave their bits behind; once they
+    // outnumber half the live keys the filter is rebuilt from the nodes.
+    void setBloomFilter(bool enabled, int bitsPerKey = 10);
+    bool hasBloomFilter() const;
+
+    // Writes every entry to a snapshot file (see hashsnapshot.h) that
+    // MappedHashMap can serve without loading. Cached hashes are stored as
+    // they are unless HashPolicy is seeded, in which case keys are hashed
+    // again with xxHash3. On failure returns false and sets *errorString.
+    bool saveSnapshot(const QString &path, QString *errorString = nullptr) const;
+
+    // When enabled, load-factor growth migrates bucketsPerOperation old
+    // buckets per insert/put/get/erase instead of rehashing in one go.
+    void setIncrementalRehash(bool enabled, int bucketsPerOperation = 8);
+    bool isRehashing() const;
+
+    // Visualization helpers. Always empty when tracing is disabled.
+    const HashStepTrace &lastSteps() const;
     void clearSteps();
+
+    // Occupancy statistics over the current bucket array, maintained on
+    // every insert, erase and rehash and read in O(1). During an
+    // incremental migration, entries still in the old array are counted
+    // under the bucket they will move to, which costs a walk of the old
+    // chains not yet migrated.
     QVector<int> bucketSizes() const;
+    // Entry i is the number of buckets whose chain holds exactly i nodes.
+    QVector<int> chainLengthHistogram() const;
+    int longestChain() const;
+
+    // Operation counts, chain nodes visited per lookup, rehash cost and
+    // sampled per-operation latencies (see hashmetrics.h). Off by default;
+    // once on, counting costs a few increments per call and one call in
+    // sampleEvery reads the clock. Const lookups update the counters too,
+    // so metrics must stay off while several threads read the map.
+    void setMetricsEnabled(bool enabled, int sampleEvery = 16);
+    bool metricsEnabled() const;
+    HashMapMetrics metrics() const;
+    void resetMetrics();
 
 private:
+    static constexpr quint32 kNil = 0xFFFFFFFFu;
+
     struct Node {
         QString key;
         QString value;
+        size_t hash = 0;
+        quint32 next = kNil;
     };
 
-    std::vector<std::forward_list<Node>> buckets_;
+    std::vector<Node> nodes_;    // chain nodes and free slots
+    std::vector<quint32> heads_; // first node of each bucket's chain, or kNil
+    IndexPolicy index_;          // maps hashes onto heads_
+    quint32 freeList_ = kNil;
+
+    // Incremental rehash state. While oldHeads_ is non-empty, old buckets
+    // [0, migrateCursor_) have moved to heads_ and the rest are pending.
+    std::vector<quint32> oldHeads_;
+    IndexPolicy oldIndex_;
+    size_t migrateCursor_ = 0;
+    bool incrementalRehash_ = false;
+    int migrateBucketsPerOp_ = 8;
+
     int numElements_ = 0;
     float maxLoadFactor_ = 0.75f;
-    QVector<QString> lastSteps_;
+    float minLoadFactor_ = 0.1f;
+    int minBucketCount_ = 1; // initial bucket count; shrinking stops here
+    StepRecorder<TracePolicy> trace_;
 
-    inline int indexFor(const QString &key, int bucketCount) const {
-        // qHash returns a 32-bit unsigned; cast to size_t for modulo math
-        const size_t hash = static_cast<size_t>(qHash(key));
-        return static_cast<int>(hash % static_cast<size_t>(bucketCount));
-    }
+    // Bloom filter state. During an incremental migration nextFilter_ is
+    // filled as buckets move and replaces filter_ when the migration ends.
+    bool filterEnabled_ = false;
+    int filterBitsPerKey_ = 10;
+    int filterStale_ = 0;     // erased keys still set in filter_
+    int nextFilterStale_ = 0; // erased keys still set in nextFilter_
+    BlockedBloomFilter filter_;
+    BlockedBloomFilter nextFilter_;
+
+    QVector<int> bucketSizes_;    // chain length per bucket of heads_, migrated entries only
+    QVector<int> chainHistogram_; // bucket count per chain length
+    int longestChain_ = 0;
+
+    std::unique_ptr<HashMetricsRecorder> metrics_; // null while metrics are off
+
+    // Iteration covers heads_ followed by the old buckets still pending
+    // migration, addressed together as slots.
+    size_t slotCount() const;
+    quint32 slotHead(size_t slot) const;
 
-    void addStep(const QString &text);
-    bool emplaceOrAssign(const QString &key, const QString &value, bool assignIfExists);
+    quint32 allocateNode(QString key, QString value, size_t hash);
+    void releaseNode(quint32 index);
+    quint32 &locateChain(size_t hash, int &index);
+    bool keyMatches(const Node &node, size_t hash, QStringView key, int keyRef);
+    void resetBuckets(int newBucketCount);
+    // Bucket count reserve() sizes for expectedElements entries.
+    int reservedBucketCount(int expectedElements) const;
+    void resetOccupancy();
+    void countAdded(int bucket);
+    void countRemoved(int bucket);
+    bool inCurrentTable(size_t hash) const;
+    void relinkChain(quint32 head);
+    void advanceMigration();
+    void finishMigration();
+    quint32 findNode(QStringView key, size_t hash) const;
+    std::pair<quint32, bool> emplaceOrAssign(QString key, QString value, size_t hash, bool assignIfExists);
     void maybeGrow();
+    void maybeShrink();
+    qsizetype filterCapacity(int bucketCount) const;
+    void rebuildFilter();
+    bool filterRejects(size_t hash);
+    void filterAdded(size_t hash);
+    void filterRemoved(size_t hash);
+    void beginResize(int newBucketCount);
+
+    template <typename InputIt>
+    int loadRange(InputIt first, InputIt last, bool assignIfExists);
+};
+
+template <typename TracePolicy, typename IndexPolicy, typename HashPolicy>
+template <bool Const>
+class BasicHashMap<TracePolicy, IndexPolicy, HashPolicy>::IteratorBase {
+    using Map = std::conditional_t<Const, const BasicHashMap, BasicHashMap>;
+
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using difference_type = std::ptrdiff_t;
+    using value_type = QString;
+    using pointer = std::conditional_t<Const, const QString *, QString *>;
+    using reference = std::conditional_t<Const, const QString &, QString &>;
+
+    IteratorBase() = default;
+    template <bool C = Const, typename = std::enable_if_t<C>>
+    IteratorBase(const IteratorBase<false> &other)
+        : map_(other.map_), slot_(other.slot_), endSlot_(other.endSlot_), node_(other.node_) {}
+
+    const QString &key() const { return map_->nodes_[node_].key; }
+    reference value() const { return map_->nodes_[node_].value; }
+    reference operator*() const { return value(); }
+    pointer operator->() const { return &value(); }
+
+    IteratorBase &operator++() {
+        node_ = map_->nodes_[node_].next;
+        if (node_ == kNil) seek(slot_ + 1);
+        return *this;
+    }
+    IteratorBase operator++(int) {
+        IteratorBase previous = *this;
+        ++*this;
+        return previous;
+    }
+
+    // Node indices are unique and every end position holds kNil.
+    friend bool operator==(const IteratorBase &a, const IteratorBase &b) { return a.node_ == b.node_; }
+    friend bool operator!=(const IteratorBase &a, const IteratorBase &b) { return a.node_ != b.node_; }
+
+private:
+    friend class BasicHashMap;
+    template <bool>
+    friend class IteratorBase;
+
+    IteratorBase(Map *map, size_t firstSlot, size_t endSlot) : map_(map), endSlot_(endSlot) { seek(firstSlot); }
+
+    void seek(size_t slot) {
+        for (slot_ = slot; slot_ < endSlot_; ++slot_) {
+            node_ = map_->slotHead(slot_);
+            if (node_ != kNil) return;
+        }
+        node_ = kNil;
+    }
+
+    Map *map_ = nullptr;
+    size_t slot_ = 0;
+    size_t endSlot_ = 0;
+    quint32 node_ = kNil;
 };
 
+template <typename TracePolicy, typename IndexPolicy, typename HashPolicy>
+template <typename Function>
+void BasicHashMap<TracePolicy, IndexPolicy, HashPolicy>::parallelForEach(Function f) const {
+    const size_t slotTotal = slotCount();
+    const int chunks = parallelChunkCount(slotTotal);
+    parallelFor(chunks, [&](int chunk) {
+        const size_t first = slotTotal * static_cast<size_t>(chunk) / static_cast<size_t>(chunks);
+        const size_t last = slotTotal * static_cast<size_t>(chunk + 1) / static_cast<size_t>(chunks);
+        for (const_iterator it(this, first, last), end(this, last, last); it != end; ++it) {
+            f(it.key(), it.value());
+        }
+    });
+}
+
+template <typename TracePolicy, typename IndexPolicy, typename HashPolicy>
+template <typename T, typename MapFunction, typename ReduceFunction>
+T BasicHashMap<TracePolicy, IndexPolicy, HashPolicy>::parallelReduce(T identity, MapFunction mapFn, ReduceFunction reduceFn) const {
+    const size_t slotTotal = slotCount();
+    const int chunks = parallelChunkCount(slotTotal);
+    // One optional per chunk keeps T free of a default constructor and of
+    // std::vector<bool> packing, which would make neighbouring writes race.
+    std::vector<std::optional<T>> partial(static_cast<size_t>(chunks));
+    parallelFor(chunks, [&](int chunk) {
+        const size_t first = slotTotal * static_cast<size_t>(chunk) / static_cast<size_t>(chunks);
+        const size_t last = slotTotal * static_cast<size_t>(chunk + 1) / static_cast<size_t>(chunks);
+        T accumulated = identity;
+        for (const_iterator it(this, first, last), end(this, last, last); it != end; ++it) {
+            accumulated = reduceFn(std::move(accumulated), mapFn(it.key(), it.value()));
+        }
+        partial[static_cast<size_t>(chunk)].emplace(std::move(accumulated));
+    });
+    T result = std::move(identity);
+    for (std::optional<T> &value : partial) {
+        result = reduceFn(std::move(result), std::move(*value));
+    }
+    return result;
+}
+
+template <typename TracePolicy, typename IndexPolicy, typename HashPolicy>
+template <typename InputIt>
+int BasicHashMap<TracePolicy, IndexPolicy, HashPolicy>::loadRange(InputIt first, InputIt last, bool assignIfExists) {
+    using Category = typename std::iterator_traits<InputIt>::iterator_category;
+    constexpr bool presized = std::is_base_of_v<std::forward_iterator_tag, Category>;
+
+    clearSteps();
+    const int sizeBefore = numElements_;
+    const int bucketsBefore = bucketCount();
+    // Suspended before presizing too: a traced rehash would record a step
+    // per node already in the map. The bucket change is summarized below.
+    trace_.setSuspended(true);
+    int pairs = 0;
+    if constexpr (presized) {
+        pairs = static_cast<int>(std::distance(first, last));
+        reserve(numElements_ + pairs);
+    }
+
+    for (; first != last; ++first) {
+        auto &&pair = *first;
+        if constexpr (!presized) {
+            maybeGrow();
+            advanceMigration();
+            ++pairs;
+        }
+        const size_t hash = HashPolicy::hash(pair.first);
+        (void)emplaceOrAssign(std::forward<decltype(pair)>(pair).first,
+                              std::forward<decltype(pair)>(pair).second, hash, assignIfExists);
+    }
+    trace_.setSuspended(false);
+    if (metrics_) metrics_->countOperations(assignIfExists ? HashOperation::Put : HashOperation::Insert, pairs);
+
+    const int inserted = numElements_ - sizeBefore;
+    trace_.add(HashStepOp::BulkLoad, [&](HashStep &s) {
+        s.bucket = pairs;
+        s.count = inserted;
+        s.matched = assignIfExists;
+    });
+    if (bucketCount() != bucketsBefore) {
+        trace_.add(HashStepOp::Rehashing, [&](HashStep &s) {
+            s.count = bucketsBefore;
+            s.bucket = bucketCount();
+        });
+    }
+    trace_.add(HashStepOp::NewSize, [&](HashStep &s) {
+        s.count = numElements_;
+        s.loadFactor = loadFactor();
+    });
+    return inserted;
+}
+
+// Tracing build used by the visualizer.
+using HashMap = BasicHashMap<StepTrace>;
+
+// Trace-free build for headless workloads.
+using FastHashMap = BasicHashMap<NoTrace>;
 
+extern template class BasicHashMap<StepTrace, ModuloIndex>;
+extern template class BasicHashMap<StepTrace, PowerOfTwoIndex>;
+extern template class BasicHashMap<StepTrace, PrimeIndex>;
+extern template class BasicHashMap<StepTrace, FastRangeIndex>;
+extern template class BasicHashMap<NoTrace, ModuloIndex>;
+extern template class BasicHashMap<NoTrace, PowerOfTwoIndex>;
+extern template class BasicHashMap<NoTrace, PrimeIndex>;
+extern template class BasicHashMap<NoTrace, FastRangeIndex>;
+extern template class BasicHashMap<StepTrace, ModuloIndex, WyHash>;
+extern template class BasicHashMap<StepTrace, ModuloIndex, XxHash3>;
+extern template class BasicHashMap<StepTrace, ModuloIndex, Fnv1aHash>;
+extern template class BasicHashMap<NoTrace, ModuloIndex, WyHash>;
+extern template class BasicHashMap<NoTrace, ModuloIndex, XxHash3>;
+extern template class BasicHashMap<NoTrace, ModuloIndex, Fnv1aHash>;
@@ -1,10 +1,12 @@
 #include "hashmapvisualization.h"
+#include "hashquality.h"
 #include <QPainter>
 #include <QLinearGradient>
 #include <QFont>
 #include <QFontDatabase>
 #include <QDebug>
 #include <QMessageBox>
+#include <QFileDialog>
 #include <QRandomGenerator>
 #include <QGraphicsDropShadowEffect>
 #include <QScrollBar>
@@ -12,12 +14,13 @@
 
 HashMapVisualization::HashMapVisualization(QWidget *parent)
     : QWidget(parent)
-    , hashMap(new HashMap(8, 0.75f))
+    , hashMap(makeHashEngine(HashEngineKind::Chaining, 8))
     , animationTimer(new QTimer(this))
     , highlightAnimation(nullptr)
     , highlightRect(nullptr)
 {
     setupUI();
+    operationLog.setInitialBucketCount(hashMap->bucketCount());
     updateVisualization();
     updateStepTrace();
     
@@ -30,7 +33,6 @@ HashMapVisualization::HashMapVisualization(QWidget *parent)
 
 HashMapVisualization::~HashMapVisualization()
 {
-    delete hashMap;
 }
 
 void HashMapVisualization::setupUI()
@@ -165,18 +167,22 @@ void HashMapVisualization::setupControlPanel()
     deleteButton = new QPushButton("Delete");
     clearButton = new QPushButton("Clear All");
     randomizeButton = new QPushButton("Randomize");
+    saveLogButton = new QPushButton("Save Log");
+    saveLogButton->setToolTip("Save every operation so far as a log that AdvDS_replay can run headless");
     
     styleButton(insertButton, "#28a745");
     styleButton(searchButton, "#17a2b8");
     styleButton(deleteButton, "#dc3545");
     styleButton(clearButton, "#6c757d");
     styleButton(randomizeButton, "#fd7e14");
+    styleButton(saveLogButton, "#6f42c1");
     
     buttonLayout->addWidget(insertButton);
     buttonLayout->addWidget(searchButton);
     buttonLayout->addWidget(deleteButton);
     buttonLayout->addWidget(clearButton);
     buttonLayout->addWidget(randomizeButton);
+    buttonLayout->addWidget(saveLogButton);
     
     // Stats row
     QHBoxLayout *statsLayout = new QHBoxLayout();
@@ -184,17 +190,49 @@ void HashMapVisualization::setupControlPanel()
     sizeLabel = new QLabel("Size: 0");
     bucketCountLabel = new QLabel("Buckets: 8");
     loadFactorLabel = new QLabel("Load Factor: 0.00");
+    distributionLabel = new QLabel("χ²/df: -");
+    distributionLabel->setToolTip("Chi-square of bucket occupancy per degree of freedom; about 1.0 for a uniform hash, and the longest chain");
     
     QString statsStyle = "color: #495057; font-weight: bold; padding: 5px;";
     sizeLabel->setStyleSheet(statsStyle);
     bucketCountLabel->setStyleSheet(statsStyle);
     loadFactorLabel->setStyleSheet(statsStyle);
+    distributionLabel->setStyleSheet(statsStyle);
     
     statsLayout->addWidget(sizeLabel);
     statsLayout->addWidget(bucketCountLabel);
     statsLayout->addWidget(loadFactorLabel);
+    statsLayout->addWidget(distributionLabel);
     statsLayout->addStretch();
     
+    QLabel *engineLabel = new QLabel("Engine:");
+    engineLabel->setStyleSheet(statsStyle);
+    engineSelector = new QComboBox();
+    engineSelector->addItem("Separate chaining", static_cast<int>(HashEngineKind::Chaining));
+    engineSelector->addItem("Robin Hood probing", static_cast<int>(HashEngineKind::RobinHood));
+    engineSelector->addItem("Swiss table", static_cast<int>(HashEngineKind::Swiss));
+    engineSelector->setCursor(Qt::PointingHandCursor);
+    statsLayout->addWidget(engineLabel);
+    statsLayout->addWidget(engineSelector);
+    
+    QLabel *hashLabel = new QLabel("Hash:");
+    hashLabel->setStyleSheet(statsStyle);
+    hashSelector = new QComboBox();
+    hashSelector->addItem("qHash", static_cast<int>(HashFunctionKind::Qt));
+    hashSelector->addItem("wyhash", static_cast<int>(HashFunctionKind::Wy));
+    hashSelector->addItem("xxHash3", static_cast<int>(HashFunctionKind::Xxh3));
+    hashSelector->addItem("FNV-1a", static_cast<int>(HashFunctionKind::Fnv1a));
+    hashSelector->setCursor(Qt::PointingHandCursor);
+    hashSelector->setToolTip("Hash function used by the separate chaining engine");
+    statsLayout->addWidget(hashLabel);
+    statsLayout->addWidget(hashSelector);
+    
+    bloomFilterCheck = new QCheckBox("Bloom filter");
+    bloomFilterCheck->setStyleSheet(statsStyle);
+    bloomFilterCheck->setCursor(Qt::PointingHandCursor);
+    bloomFilterCheck->setToolTip("Let the separate chaining engine rule out absent keys before visiting a bucket");
+    statsLayout->addWidget(bloomFilterCheck);
+    
     controlLayout->addLayout(inputLayout);
     controlLayout->addLayout(buttonLayout);
     controlLayout->addLayout(statsLayout);
@@ -207,6 +245,12 @@ void HashMapVisualization::setupControlPanel()
     connect(deleteButton, &QPushButton::clicked, this, &HashMapVisualization::onDeleteClicked);
     connect(clearButton, &QPushButton::clicked, this, &HashMapVisualization::onClearClicked);
     connect(randomizeButton, &QPushButton::clicked, this, &HashMapVisualization::onRandomizeClicked);
+    connect(saveLogButton, &QPushButton::clicked, this, &HashMapVisualization::onSaveLogClicked);
+    connect(engineSelector, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &HashMapVisualization::onEngineChanged);
+    connect(hashSelector, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &HashMapVisualization::onHashFunctionChanged);
+    connect(bloomFilterCheck, &QCheckBox::toggled, this, &HashMapVisualization::onBloomFilterToggled);
 }
 
 void HashMapVisualization::setupStepTracePanel()
@@ -234,10 +278,15 @@ void HashMapVisualization::setupStepTracePanel()
     stepsTitle->setStyleSheet("color: #2d1b69; padding-bottom: 10px;");
     stepsTitle->setAlignment(Qt::AlignCenter);
     
-    // Steps list
-    stepsList = new QListWidget();
+    // Steps list (rows are formatted lazily by the model)
+    stepModel = new HashStepModel(this);
+    stepModel->setTrace(&hashMap->lastSteps());
+    stepsList = new QListView();
+    stepsList->setModel(stepModel);
+    stepsList->setUniformItemSizes(true);
+    stepsList->setEditTriggers(QAbstractItemView::NoEditTriggers);
     stepsList->setStyleSheet(R"(
-        QListWidget {
+        QListView {
             background-color: white;
             border: 1px solid #dee2e6;
             border-radius: 8px;
@@ -245,19 +294,41 @@ void HashMapVisualization::setupStepTracePanel()
             font-family: 'Consolas', 'Monaco', monospace;
             font-size: 12px;
         }
-        QListWidget::item {
+        QListView::item {
             padding: 8px;
             border-bottom: 1px solid #f1f3f4;
             color: #495057;
         }
-        QListWidget::item:selected {
+        QListView::item:selected {
             background-color: #e3f2fd;
             color: #1976d2;
         }
     )");
     
+    // Metrics panel (counters since the engine was built)
+    metricsTitle = new QLabel("Operation Metrics");
+    metricsTitle->setFont(stepsFont);
+    metricsTitle->setStyleSheet("color: #2d1b69; padding-top: 10px;");
+    metricsTitle->setAlignment(Qt::AlignCenter);
+    
+    metricsLabel = new QLabel();
+    metricsLabel->setTextInteractionFlags(Qt::TextSelectableByMouse);
+    metricsLabel->setStyleSheet(R"(
+        QLabel {
+            background-color: white;
+            border: 1px solid #dee2e6;
+            border-radius: 8px;
+            padding: 8px;
+            color: #495057;
+            font-family: 'Consolas', 'Monaco', monospace;
+            font-size: 12px;
+        }
+    )");
+    
     rightLayout->addWidget(stepsTitle);
     rightLayout->addWidget(stepsList, 1);
+    rightLayout->addWidget(metricsTitle);
+    rightLayout->addWidget(metricsLabel);
 }
 
 void HashMapVisualization::styleButton(QPushButton *button, const QString &color)
@@ -320,6 +391,10 @@ void HashMapVisualization::drawBuckets()
     
     const int bucketCount = hashMap->bucketCount();
     const QVector<int> bucketSizes = hashMap->bucketSizes();
+    const bool openAddressing = hashMap->isOpenAddressing();
+    const QVector<int> probeLengths = hashMap->probeLengths();
+    const QVector<int> controlBytes = hashMap->controlBytes();
+    const bool swissTable = !controlBytes.isEmpty();
     
     // Calculate layout
     const int bucketsPerRow = std::min(MAX_VISIBLE_BUCKETS, bucketCount);
@@ -339,11 +414,19 @@ void HashMapVisualization::drawBuckets()
         const int x = startX + col * (BUCKET_WIDTH + BUCKET_SPACING);
         const int y = row * (BUCKET_HEIGHT + 80); // Extra space for chains
         
-        // Draw bucket rectangle
+        // Draw bucket rectangle; open-addressing slots are tinted by probe
+        // distance so long probe sequences stand out
+        QColor fill(255, 255, 255);
+        if (swissTable && controlBytes[i] >= 0) {
+            fill = QColor(212, 237, 218);
+        } else if (openAddressing && !swissTable && probeLengths[i] >= 0) {
+            const int distance = std::min(probeLengths[i], 4);
+            fill = QColor(212 + distance * 10, 237 - distance * 25, 218 - distance * 40);
+        }
         QGraphicsRectItem *bucketRect = scene->addRect(
             x, y, BUCKET_WIDTH, BUCKET_HEIGHT,
             QPen(QColor(52, 58, 64), 2),
-            QBrush(QColor(255, 255, 255))
+            QBrush(fill)
         );
         bucketRects[i] = bucketRect;
         
@@ -355,17 +438,29 @@ void HashMapVisualization::drawBuckets()
         indexFont.setBold(true);
         indexText->setFont(indexFont);
         
-        // Bucket size label
-        QGraphicsTextItem *sizeText = scene->addText(QString("(%1)").arg(bucketSizes[i]));
+        // Bucket size label (probe distance for Robin Hood, control byte for
+        // Swiss table metadata)
+        QString sizeLabel;
+        if (!openAddressing) {
+            sizeLabel = QString("(%1)").arg(bucketSizes[i]);
+        } else if (swissTable) {
+            sizeLabel = controlBytes[i] >= 0 ? QString("0x%1").arg(controlBytes[i], 2, 16, QLatin1Char('0'))
+                        : controlBytes[i] == HashEngine::kDeletedControl ? QString("(deleted)")
+                        : QString("(empty)");
+        } else {
+            sizeLabel = probeLengths[i] < 0 ? QString("(empty)") : QString("d=%1").arg(probeLengths[i]);
+        }
+        QGraphicsTextItem *sizeText = scene->addText(sizeLabel);
         sizeText->setPos(x + BUCKET_WIDTH/2 - 10, y + BUCKET_HEIGHT + 5);
         sizeText->setDefaultTextColor(QColor(108, 117, 125));
         bucketTexts[i] = sizeText;
         
-        // Draw chain items (placeholder - would need actual key-value pairs)
+        // Draw the keys chained in this bucket
         QVector<QGraphicsTextItem*> chainItems;
-        for (int j = 0; j < bucketSizes[i]; ++j) {
+        const QStringList chainKeys = openAddressing ? QStringList() : hashMap->bucketKeys(i);
+        for (int j = 0; j < chainKeys.size(); ++j) {
             const int chainY = y + BUCKET_HEIGHT + 30 + j * CHAIN_ITEM_HEIGHT;
-            QGraphicsTextItem *chainItem = scene->addText(QString("Item %1").arg(j + 1));
+            QGraphicsTextItem *chainItem = scene->addText(chainKeys[j]);
             chainItem->setPos(x + 5, chainY);
             chainItem->setDefaultTextColor(QColor(40, 167, 69));
             QFont chainFont = chainItem->font();
@@ -388,15 +483,10 @@ void HashMapVisualization::updateVisualization()
 
 void HashMapVisualization::updateStepTrace()
 {
-    stepsList->clear();
-    const QVector<QString> &steps = hashMap->lastSteps();
-    
-    for (const QString &step : steps) {
-        stepsList->addItem(step);
-    }
+    stepModel->refresh();
     
     // Auto-scroll to bottom
-    if (stepsList->count() > 0) {
+    if (stepModel->rowCount() > 0) {
         stepsList->scrollToBottom();
     }
 }
@@ -406,6 +496,50 @@ void HashMapVisualization::showStats()
     sizeLabel->setText(QString("Size: %1").arg(hashMap->size()));
     bucketCountLabel->setText(QString("Buckets: %1").arg(hashMap->bucketCount()));
     loadFactorLabel->setText(QString("Load Factor: %1").arg(hashMap->loadFactor(), 0, 'f', 2));
+    if (hashMap->isOpenAddressing() || hashMap->size() == 0) {
+        distributionLabel->setText("χ²/df: -");
+    } else {
+        distributionLabel->setText(QString("χ²/df: %1  Longest: %2")
+                                       .arg(chiSquareRatioFromHistogram(hashMap->chainLengthHistogram()), 0, 'f', 2)
+                                       .arg(hashMap->longestChain()));
+    }
+    
+    if (hashMap->kind() != HashEngineKind::Chaining) {
+        metricsLabel->setText("Metrics are collected by the chaining engine only.");
+        return;
+    }
+    
+    const HashMapMetrics metrics = hashMap->metrics();
+    QStringList lines;
+    QStringList counts;
+    for (int op = 0; op < kHashOperationCount; ++op) {
+        counts.append(QString("%1 %2").arg(hashOperationName(static_cast<HashOperation>(op))).arg(metrics.operations[op]));
+    }
+    lines.append(counts.join("  "));
+    lines.append(QString("Hits: %1  Misses: %2  Hit ratio: %3%")
+                     .arg(metrics.hits)
+                     .arg(metrics.misses)
+                     .arg(metrics.hitRatio() * 100.0, 0, 'f', 1));
+    lines.append(QString("Chain nodes per lookup: %1").arg(metrics.averageChainVisits(), 0, 'f', 2));
+    lines.append(QString("Rehashes: %1  Time: %2  Moves: %3")
+                     .arg(metrics.rehashes)
+                     .arg(formatNanos(static_cast<double>(metrics.rehashNanos)))
+                     .arg(metrics.elementMoves));
+    lines.append(QString());
+    lines.append(QString("%1%2%3%4").arg(QStringLiteral("latency"), -10)
+                     .arg(QStringLiteral("p50"), 10)
+                     .arg(QStringLiteral("p99"), 10)
+                     .arg(QStringLiteral("p99.9"), 10));
+    for (int op = 0; op < kHashOperationCount; ++op) {
+        const LatencySummary &latency = metrics.latency[op];
+        if (latency.samples == 0) continue;
+        lines.append(QString("%1%2%3%4")
+                         .arg(QLatin1String(hashOperationName(static_cast<HashOperation>(op))), -10)
+                         .arg(formatNanos(latency.p50Nanos), 10)
+                         .arg(formatNanos(latency.p99Nanos), 10)
+                         .arg(formatNanos(latency.p999Nanos), 10));
+    }
+    metricsLabel->setText(lines.join('\n'));
 }
 
 void HashMapVisualization::animateOperation(const QString &operation)
@@ -432,6 +566,7 @@ void HashMapVisualization::onInsertClicked()
     }
     
     hashMap->put(key, value);
+    operationLog.append(LoggedOp::Put, key, value);
     animateOperation("Insert");
     
     // Clear inputs
@@ -449,6 +584,7 @@ void HashMapVisualization::onSearchClicked()
     }
     
     auto result = hashMap->get(key);
+    operationLog.append(LoggedOp::Get, key);
     animateOperation("Search");
     
     if (result.has_value()) {
@@ -470,6 +606,7 @@ void HashMapVisualization::onDeleteClicked()
     }
     
     bool removed = hashMap->erase(key);
+    operationLog.append(LoggedOp::Erase, key);
     animateOperation("Delete");
     
     if (removed) {
@@ -486,6 +623,7 @@ void HashMapVisualization::onDeleteClicked()
 void HashMapVisualization::onClearClicked()
 {
     hashMap->clear();
+    operationLog.append(LoggedOp::Clear);
     animateOperation("Clear");
     QMessageBox::information(this, "Clear", "HashMap cleared successfully.");
 }
@@ -501,8 +639,70 @@ void HashMapVisualization::onRandomizeClicked()
     for (int i = 0; i < 6; ++i) {
         const int idx = QRandomGenerator::global()->bounded(sampleKeys.size());
         hashMap->put(sampleKeys[idx], sampleValues[idx]);
+        operationLog.append(LoggedOp::Put, sampleKeys[idx], sampleValues[idx]);
     }
     
     animateOperation("Randomize");
     QMessageBox::information(this, "Randomize", "Added random key-value pairs.");
 }
+
+void HashMapVisualization::onSaveLogClicked()
+{
+    if (operationLog.isEmpty()) {
+        QMessageBox::information(this, "Save Log", "No operations recorded yet.");
+        return;
+    }
+    
+    const QString path = QFileDialog::getSaveFileName(this, "Save Operation Log", "session.oplog",
+                                                      "Operation logs (*.oplog);;All files (*)");
+    if (path.isEmpty()) {
+        return;
+    }
+    
+    QString error;
+    if (!operationLog.save(path, &error)) {
+        QMessageBox::warning(this, "Save Log", QString("Could not save the log: %1").arg(error));
+        return;
+    }
+    QMessageBox::information(this, "Save Log",
+                             QString("Saved %1 operations (%2 bytes).").arg(operationLog.size()).arg(operationLog.byteSize()));
+}
+
+void HashMapVisualization::onEngineChanged(int index)
+{
+    const auto kind = static_cast<HashEngineKind>(engineSelector->itemData(index).toInt());
+    if (hashMap && hashMap->kind() == kind) {
+        return;
+    }
+    
+    // Only the chaining engine is parameterized on the hash function and
+    // has a Bloom filter
+    hashSelector->setEnabled(kind == HashEngineKind::Chaining);
+    bloomFilterCheck->setEnabled(kind == HashEngineKind::Chaining);
+    rebuildEngine(kind, static_cast<HashFunctionKind>(hashSelector->currentData().toInt()));
+    animateOperation("Switch Engine");
+}
+
+void HashMapVisualization::onHashFunctionChanged(int index)
+{
+    const auto hash = static_cast<HashFunctionKind>(hashSelector->itemData(index).toInt());
+    rebuildEngine(hashMap->kind(), hash);
+    animateOperation("Switch Hash");
+}
+
+void HashMapVisualization::onBloomFilterToggled(bool enabled)
+{
+    hashMap->setBloomFilter(enabled);
+    updateVisualization();
+}
+
+void HashMapVisualization::rebuildEngine(HashEngineKind kind, HashFunctionKind hash)
+{
+    // Switching engines starts from an empty table of the same size
+    std::unique_ptr<HashEngine> engine = makeHashEngine(kind, 8, hash);
+    engine->setBloomFilter(bloomFilterCheck->isChecked());
+    stepModel->setTrace(&engine->lastSteps());
+    hashMap = std::move(engine);
+    // The new engine starts empty; a replay has to as well
+    operationLog.append(LoggedOp::Clear);
+}
@@ -8,7 +8,7 @@
 #include <QPushButton>
 #include <QLineEdit>
 #include <QLabel>
-#include <QListWidget>
+#include <QListView>
 #include <QGraphicsView>
 #include <QGraphicsScene>
 #include <QGraphicsRectItem>
@@ -19,7 +19,12 @@
 #include <QSequentialAnimationGroup>
 #include <QScrollArea>
 #include <QSplitter>
-#include "hashmap.h"
+#include <QComboBox>
+#include <QCheckBox>
+#include <memory>
+#include "hashengine.h"
+#include "oplog.h"
+#include "hashstepmodel.h"
 
 class HashMapVisualization : public QWidget
 {
@@ -39,6 +44,10 @@ private slots:
     void onDeleteClicked();
     void onClearClicked();
     void onRandomizeClicked();
+    void onSaveLogClicked();
+    void onEngineChanged(int index);
+    void onHashFunctionChanged(int index);
+    void onBloomFilterToggled(bool enabled);
     void updateVisualization();
     void updateStepTrace();
 
@@ -52,6 +61,7 @@ private:
     void drawBuckets();
     void animateOperation(const QString &operation);
     void showStats();
+    void rebuildEngine(HashEngineKind kind, HashFunctionKind hash);
 
     // UI Components
     QSplitter *mainSplitter;
@@ -74,19 +84,28 @@ private:
     QPushButton *deleteButton;
     QPushButton *clearButton;
     QPushButton *randomizeButton;
+    QPushButton *saveLogButton;
+    QComboBox *engineSelector;
+    QComboBox *hashSelector;
+    QCheckBox *bloomFilterCheck;
     
     // Stats panel
     QLabel *sizeLabel;
     QLabel *bucketCountLabel;
     QLabel *loadFactorLabel;
+    QLabel *distributionLabel;
     
     // Right panel - step trace
     QVBoxLayout *rightLayout;
     QLabel *stepsTitle;
-    QListWidget *stepsList;
+    QListView *stepsList;
+    HashStepModel *stepModel;
+    QLabel *metricsTitle;
+    QLabel *metricsLabel;
     
     // Data and visualization
-    HashMap *hashMap;
+    std::unique_ptr<HashEngine> hashMap;
+    OperationLog operationLog; // every operation applied to hashMap, for AdvDS_replay
     QVector<QGraphicsRectItem*> bucketRects;
     QVector<QGraphicsTextItem*> bucketTexts;
     QVector<QVector<QGraphicsTextItem*>> chainTexts;
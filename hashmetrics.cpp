@@ -0,0 +1,113 @@
+#include "hashmetrics.h"
+
+#include <algorithm>
+#include <cmath>
+
+const char *hashOperationName(HashOperation op) {
+    switch (op) {
+    case HashOperation::Insert:
+        return "insert";
+    case HashOperation::Put:
+        return "put";
+    case HashOperation::Get:
+        return "get";
+    case HashOperation::Contains:
+        return "contains";
+    case HashOperation::Erase:
+        return "erase";
+    }
+    return "";
+}
+
+QString formatNanos(double nanos) {
+    if (nanos >= 1e6) return QStringLiteral("%1 ms").arg(nanos / 1e6, 0, 'f', 2);
+    if (nanos >= 1e3) return QStringLiteral("%1 µs").arg(nanos / 1e3, 0, 'f', 1);
+    return QStringLiteral("%1 ns").arg(nanos, 0, 'f', 0);
+}
+
+void LatencyHistogram::clear() {
+    buckets_.fill(0);
+    count_ = 0;
+}
+
+int LatencyHistogram::bucketOf(quint64 nanos) {
+    // Values below 4 get a bucket each; above that the exponent picks the
+    // octave and the two bits after the leading one pick the quarter.
+    if (nanos < 4) return static_cast<int>(nanos);
+    int exponent = 63;
+    while (!(nanos >> exponent)) --exponent;
+    const int quarter = static_cast<int>((nanos >> (exponent - 2)) & 3);
+    return 4 * (exponent - 1) + quarter;
+}
+
+double LatencyHistogram::bucketMidpoint(int bucket) {
+    if (bucket < 4) return bucket;
+    const int exponent = bucket / 4 + 1;
+    const double width = std::ldexp(1.0, exponent - 2);
+    const double lower = (4 + bucket % 4) * width;
+    return lower + width / 2.0;
+}
+
+double LatencyHistogram::percentile(double q) const {
+    if (count_ == 0) return 0.0;
+    const quint64 rank = std::max<quint64>(1, static_cast<quint64>(std::ceil(std::clamp(q, 0.0, 1.0) * count_)));
+    quint64 seen = 0;
+    for (int bucket = 0; bucket < kBucketCount; ++bucket) {
+        seen += buckets_[static_cast<size_t>(bucket)];
+        if (seen >= rank) return bucketMidpoint(bucket);
+    }
+    return bucketMidpoint(kBucketCount - 1);
+}
+
+quint64 HashMapMetrics::totalOperations() const {
+    quint64 total = 0;
+    for (quint64 count : operations) total += count;
+    return total;
+}
+
+double HashMapMetrics::hitRatio() const {
+    const quint64 lookups = hits + misses;
+    return lookups ? static_cast<double>(hits) / lookups : 0.0;
+}
+
+double HashMapMetrics::averageChainVisits() const {
+    const quint64 lookups = hits + misses;
+    return lookups ? static_cast<double>(chainVisits) / lookups : 0.0;
+}
+
+HashMetricsRecorder::HashMetricsRecorder(int sampleEvery)
+    : sampleEvery_(std::max(1, sampleEvery)),
+      untilSample_(sampleEvery_) {
+}
+
+HashMapMetrics HashMetricsRecorder::snapshot() const {
+    HashMapMetrics metrics;
+    metrics.operations = operations_;
+    metrics.hits = hits_;
+    metrics.misses = misses_;
+    metrics.chainVisits = chainVisits_;
+    metrics.rehashes = rehashes_;
+    metrics.rehashNanos = rehashNanos_;
+    metrics.elementMoves = elementMoves_;
+    for (size_t op = 0; op < latency_.size(); ++op) {
+        const LatencyHistogram &histogram = latency_[op];
+        LatencySummary &summary = metrics.latency[op];
+        summary.samples = histogram.count();
+        summary.p50Nanos = histogram.percentile(0.5);
+        summary.p99Nanos = histogram.percentile(0.99);
+        summary.p999Nanos = histogram.percentile(0.999);
+    }
+    return metrics;
+}
+
+void HashMetricsRecorder::reset() {
+    operations_.fill(0);
+    hits_ = 0;
+    misses_ = 0;
+    chainVisits_ = 0;
+    rehashes_ = 0;
+    rehashNanos_ = 0;
+    elementMoves_ = 0;
+    for (LatencyHistogram &histogram : latency_) histogram.clear();
+    untilSample_ = sampleEvery_;
+}
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <QElapsedTimer>
+#include <QString>
+#include <QtGlobal>
+#include <array>
+
+// Operation kinds counted by HashMetricsRecorder. Put covers every
+// assigning upsert (put, insert_or_assign, putRange); Contains covers
+// contains() and find().
+enum class HashOperation : quint8 {
+    Insert,
+    Put,
+    Get,
+    Contains,
+    Erase,
+};
+
+constexpr int kHashOperationCount = 5;
+
+// Lower-case name used in reports: "insert", "put", "get", ...
+const char *hashOperationName(HashOperation op);
+
+// A duration in ns, µs or ms, whichever keeps the number readable.
+QString formatNanos(double nanos);
+
+// Log-bucketed latency histogram: four buckets per power of two, so any
+// reported percentile is within 12.5% of the true sample. Fixed size, no
+// allocation, one increment per sample.
+class LatencyHistogram {
+public:
+    static constexpr int kBucketCount = 252;
+
+    void add(quint64 nanos) { ++buckets_[static_cast<size_t>(bucketOf(nanos))]; ++count_; }
+    void clear();
+
+    quint64 count() const { return count_; }
+    // Midpoint of the bucket holding the q-quantile (0 <= q <= 1).
+    double percentile(double q) const;
+
+private:
+    static int bucketOf(quint64 nanos);
+    static double bucketMidpoint(int bucket);
+
+    std::array<quint64, kBucketCount> buckets_ {};
+    quint64 count_ = 0;
+};
+
+struct LatencySummary {
+    quint64 samples = 0;
+    double p50Nanos = 0.0;
+    double p99Nanos = 0.0;
+    double p999Nanos = 0.0;
+};
+
+// Point-in-time copy of a map's counters.
+struct HashMapMetrics {
+    std::array<quint64, kHashOperationCount> operations {};
+    // Get and Contains: hits, misses and chain nodes visited to answer them.
+    quint64 hits = 0;
+    quint64 misses = 0;
+    quint64 chainVisits = 0;
+    // Full rehashes and incremental migrations alike, with the time spent
+    // relinking and the number of nodes moved.
+    quint64 rehashes = 0;
+    quint64 rehashNanos = 0;
+    quint64 elementMoves = 0;
+    std::array<LatencySummary, kHashOperationCount> latency {};
+
+    quint64 totalOperations() const;
+    double hitRatio() const;
+    double averageChainVisits() const;
+};
+
+// Counters behind HashMapMetrics. Counts are exact; latencies are sampled,
+// one operation in sampleEvery, so the clock is read rarely enough to stay
+// on in production. Not thread-safe: it is owned by one map and updated
+// under whatever serializes that map.
+class HashMetricsRecorder {
+public:
+    explicit HashMetricsRecorder(int sampleEvery = 16);
+
+    // Times one operation if the recorder samples it. A null recorder makes
+    // the timer a no-op.
+    class OperationTimer {
+    public:
+        OperationTimer(HashMetricsRecorder *recorder, HashOperation op) : recorder_(recorder), op_(op) {
+            if (!recorder_) return;
+            ++recorder_->operations_[static_cast<size_t>(op)];
+            sampled_ = --recorder_->untilSample_ == 0;
+            if (sampled_) {
+                recorder_->untilSample_ = recorder_->sampleEvery_;
+                timer_.start();
+            }
+        }
+        ~OperationTimer() {
+            if (sampled_) recorder_->latency_[static_cast<size_t>(op_)].add(static_cast<quint64>(timer_.nsecsElapsed()));
+        }
+        Q_DISABLE_COPY_MOVE(OperationTimer)
+
+    private:
+        HashMetricsRecorder *recorder_;
+        HashOperation op_;
+        bool sampled_ = false;
+        QElapsedTimer timer_;
+    };
+
+    void countOperations(HashOperation op, quint64 count) { operations_[static_cast<size_t>(op)] += count; }
+    void countLookup(bool hit, quint64 visited) {
+        ++(hit ? hits_ : misses_);
+        chainVisits_ += visited;
+    }
+    void countRehash() { ++rehashes_; }
+    void countRehashTime(quint64 nanos) { rehashNanos_ += nanos; }
+    void countMove() { ++elementMoves_; }
+
+    HashMapMetrics snapshot() const;
+    void reset();
+
+private:
+    int sampleEvery_;
+    int untilSample_;
+    std::array<quint64, kHashOperationCount> operations_ {};
+    quint64 hits_ = 0;
+    quint64 misses_ = 0;
+    quint64 chainVisits_ = 0;
+    quint64 rehashes_ = 0;
+    quint64 rehashNanos_ = 0;
+    quint64 elementMoves_ = 0;
+    std::array<LatencyHistogram, kHashOperationCount> latency_;
+};
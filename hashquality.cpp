@@ -0,0 +1,104 @@
+#include "hashquality.h"
+
+#include <QElapsedTimer>
+#include "hashfunctions.h"
+#include "hashindex.h"
+#include <algorithm>
+
+namespace {
+
+// Hashing is timed over whole passes of the sample until at least this much
+// time has elapsed, so tiny samples still give a stable figure.
+constexpr qint64 kMinTimedNanos = 20 * 1000 * 1000;
+
+double chiSquareOf(const QVector<int> &bucketSizes, qint64 keyCount) {
+    if (bucketSizes.isEmpty() || keyCount == 0) return 0.0;
+    const double expected = static_cast<double>(keyCount) / bucketSizes.size();
+    double sum = 0.0;
+    for (int observed : bucketSizes) {
+        const double diff = observed - expected;
+        sum += diff * diff / expected;
+    }
+    return sum;
+}
+
+} // namespace
+
+template <typename HashPolicy>
+HashQualityReport measureHashQuality(const QVector<QString> &keys, int bucketCount) {
+    HashQualityReport report;
+    report.name = QString::fromLatin1(HashPolicy::name);
+    report.keyCount = keys.size();
+    report.bucketCount = ModuloIndex::roundBucketCount(std::max(1, bucketCount));
+    if (keys.isEmpty()) return report;
+
+    ModuloIndex index;
+    index.setBucketCount(report.bucketCount);
+    QVector<int> sizes(report.bucketCount, 0);
+    qint64 bytes = 0;
+    for (const QString &key : keys) {
+        ++sizes[index.index(HashPolicy::hash(key))];
+        bytes += key.size() * static_cast<qint64>(sizeof(char16_t));
+    }
+    report.chiSquare = chiSquareOf(sizes, keys.size());
+    report.chiSquareRatio = report.bucketCount > 1 ? report.chiSquare / (report.bucketCount - 1) : 0.0;
+    report.longestChain = *std::max_element(sizes.begin(), sizes.end());
+
+    // The running xor, stored to a volatile, keeps the hashes from being
+    // optimized away.
+    size_t sink = 0;
+    qint64 passes = 0;
+    QElapsedTimer timer;
+    timer.start();
+    do {
+        for (const QString &key : keys) {
+            sink ^= HashPolicy::hash(key);
+        }
+        ++passes;
+    } while (timer.nsecsElapsed() < kMinTimedNanos);
+    const double nanos = static_cast<double>(timer.nsecsElapsed());
+    volatile size_t keep = sink;
+    (void)keep;
+
+    report.nanosPerKey = nanos / (static_cast<double>(passes) * keys.size());
+    report.megabytesPerSecond = static_cast<double>(bytes) * passes / nanos * 1e9 / (1024.0 * 1024.0);
+    return report;
+}
+
+QVector<HashQualityReport> compareHashFunctions(const QVector<QString> &keys, int bucketCount) {
+    return {
+        measureHashQuality<QtHash>(keys, bucketCount),
+        measureHashQuality<WyHash>(keys, bucketCount),
+        measureHashQuality<XxHash3>(keys, bucketCount),
+        measureHashQuality<Fnv1aHash>(keys, bucketCount),
+    };
+}
+
+double chiSquareRatio(const QVector<int> &bucketSizes) {
+    if (bucketSizes.size() < 2) return 0.0;
+    qint64 total = 0;
+    for (int size : bucketSizes) total += size;
+    return chiSquareOf(bucketSizes, total) / (bucketSizes.size() - 1);
+}
+
+double chiSquareRatioFromHistogram(const QVector<int> &chainHistogram) {
+    qint64 buckets = 0;
+    qint64 keys = 0;
+    for (int length = 0; length < chainHistogram.size(); ++length) {
+        buckets += chainHistogram[length];
+        keys += static_cast<qint64>(length) * chainHistogram[length];
+    }
+    if (buckets < 2 || keys == 0) return 0.0;
+    const double expected = static_cast<double>(keys) / buckets;
+    double sum = 0.0;
+    for (int length = 0; length < chainHistogram.size(); ++length) {
+        const double diff = length - expected;
+        sum += chainHistogram[length] * diff * diff / expected;
+    }
+    return sum / (buckets - 1);
+}
+
+template HashQualityReport measureHashQuality<QtHash>(const QVector<QString> &, int);
+template HashQualityReport measureHashQuality<WyHash>(const QVector<QString> &, int);
+template HashQualityReport measureHashQuality<XxHash3>(const QVector<QString> &, int);
+template HashQualityReport measureHashQuality<Fnv1aHash>(const QVector<QString> &, int);
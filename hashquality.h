@@ -0,0 +1,33 @@
+#pragma once
+
+#include <QString>
+#include <QVector>
+
+// Distribution and speed of one hash function over a key sample, with
+// keys mapped to buckets the way ModuloIndex does.
+struct HashQualityReport {
+    QString name;
+    int keyCount = 0;
+    int bucketCount = 0;
+    // Pearson chi-square of the bucket counts against a uniform spread, and
+    // the same divided by its degrees of freedom (about 1.0 when uniform).
+    double chiSquare = 0.0;
+    double chiSquareRatio = 0.0;
+    int longestChain = 0;
+    double nanosPerKey = 0.0;
+    double megabytesPerSecond = 0.0; // over the UTF-16 key bytes
+};
+
+// Runs keys through HashPolicy (see hashfunctions.h).
+template <typename HashPolicy>
+HashQualityReport measureHashQuality(const QVector<QString> &keys, int bucketCount);
+
+// One report per shipped hash policy: qHash, wyhash, xxHash3, FNV-1a.
+QVector<HashQualityReport> compareHashFunctions(const QVector<QString> &keys, int bucketCount);
+
+// Chi-square summary of an existing bucket occupancy histogram.
+double chiSquareRatio(const QVector<int> &bucketSizes);
+
+// The same figure from a chain-length histogram (entry i = buckets holding
+// i keys), in time proportional to the longest chain.
+double chiSquareRatioFromHistogram(const QVector<int> &chainHistogram);
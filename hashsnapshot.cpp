@@ -0,0 +1,308 @@
+#include "hashsnapshot.h"
+
+#include <QSaveFile>
+#include "hashfunctions.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+struct NamedHash {
+    const char *name;
+    size_t (*hash)(QStringView);
+};
+
+// Seeded functions are missing on purpose: their hashes mean nothing to
+// another process.
+constexpr NamedHash kHashFunctions[] = {
+    {WyHash::name, &WyHash::hash},
+    {XxHash3::name, &XxHash3::hash},
+    {Fnv1aHash::name, &Fnv1aHash::hash},
+};
+
+quint64 checksumBlock(const uchar *data, qsizetype size, quint64 previous) {
+    return hashfn::wyhash64(data, static_cast<size_t>(size), previous);
+}
+
+// Buffers output into checksum blocks so the checksum is known once the
+// last byte has been written.
+class ChecksumStream {
+public:
+    explicit ChecksumStream(QIODevice &device) : device_(device) { block_.reserve(snapshot::kChecksumBlock); }
+
+    void append(const void *data, qsizetype size) {
+        const uchar *p = static_cast<const uchar *>(data);
+        while (size > 0) {
+            const qsizetype n = std::min(size, snapshot::kChecksumBlock - static_cast<qsizetype>(block_.size()));
+            block_.insert(block_.end(), p, p + n);
+            p += n;
+            size -= n;
+            if (static_cast<qsizetype>(block_.size()) == snapshot::kChecksumBlock) flushBlock();
+        }
+    }
+
+    // False if any write failed.
+    bool finish() {
+        if (!block_.empty()) flushBlock();
+        return ok_;
+    }
+
+    quint64 checksum() const { return checksum_; }
+
+private:
+    void flushBlock() {
+        const qsizetype size = static_cast<qsizetype>(block_.size());
+        checksum_ = checksumBlock(block_.data(), size, checksum_);
+        ok_ = ok_ && device_.write(reinterpret_cast<const char *>(block_.data()), size) == size;
+        block_.clear();
+    }
+
+    QIODevice &device_;
+    std::vector<uchar> block_;
+    quint64 checksum_ = 0;
+    bool ok_ = true;
+};
+
+bool setError(QString *errorString, const QString &message) {
+    if (errorString) *errorString = message;
+    return false;
+}
+
+} // namespace
+
+SnapshotWriter::SnapshotWriter(const char *hashName, qsizetype expectedEntries)
+    : hashName_(hashName) {
+    entries_.reserve(static_cast<size_t>(std::max<qsizetype>(0, expectedEntries)));
+}
+
+void SnapshotWriter::add(QStringView key, QStringView value, quint64 hash) {
+    entries_.push_back(Pending{key, value, hash});
+}
+
+bool SnapshotWriter::write(const QString &path, QString *errorString) const {
+#if Q_BYTE_ORDER == Q_BIG_ENDIAN
+    return setError(errorString, QStringLiteral("Snapshots are little-endian; big-endian hosts are not supported"));
+#endif
+    if (hashName_.size() >= static_cast<qsizetype>(sizeof(snapshot::Header::hashName))) {
+        return setError(errorString, QStringLiteral("Hash function name too long"));
+    }
+    const qsizetype count = static_cast<qsizetype>(entries_.size());
+    if (count > (1 << 30)) {
+        return setError(errorString, QStringLiteral("Too many entries for one snapshot"));
+    }
+
+    // Counting sort by bucket: starts[b + 1] counts bucket b, then becomes
+    // the running prefix sum.
+    const int buckets = PowerOfTwoIndex::roundBucketCount(std::max<qsizetype>(1, count));
+    PowerOfTwoIndex index;
+    index.setBucketCount(buckets);
+    std::vector<quint64> starts(static_cast<size_t>(buckets) + 1, 0);
+    std::vector<int> bucketOf(entries_.size());
+    for (size_t i = 0; i < entries_.size(); ++i) {
+        bucketOf[i] = index.index(static_cast<size_t>(entries_[i].hash));
+        ++starts[static_cast<size_t>(bucketOf[i]) + 1];
+    }
+    for (size_t b = 1; b < starts.size(); ++b) starts[b] += starts[b - 1];
+    std::vector<quint32> order(entries_.size());
+    std::vector<quint64> cursor(starts.begin(), starts.end() - 1);
+    for (size_t i = 0; i < entries_.size(); ++i) {
+        order[cursor[static_cast<size_t>(bucketOf[i])]++] = static_cast<quint32>(i);
+    }
+
+    snapshot::Header header = {};
+    std::memcpy(header.magic, snapshot::kMagic, sizeof(header.magic));
+    header.version = snapshot::kVersion;
+    header.headerSize = sizeof(snapshot::Header);
+    std::memcpy(header.hashName, hashName_.constData(), static_cast<size_t>(hashName_.size()));
+    header.entryCount = static_cast<quint64>(count);
+    header.bucketCount = static_cast<quint64>(buckets);
+    for (const Pending &entry : entries_) {
+        header.stringBytes += static_cast<quint64>(entry.key.size() + entry.value.size()) * sizeof(char16_t);
+    }
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return setError(errorString, file.errorString());
+    }
+    // The header is written again once the checksum is known.
+    if (file.write(reinterpret_cast<const char *>(&header), sizeof(header)) != sizeof(header)) {
+        return setError(errorString, file.errorString());
+    }
+
+    ChecksumStream out(file);
+    out.append(starts.data(), static_cast<qsizetype>(starts.size() * sizeof(quint64)));
+    quint64 offset = 0;
+    for (quint32 i : order) {
+        const Pending &pending = entries_[i];
+        snapshot::Entry entry = {};
+        entry.hash = pending.hash;
+        entry.keyOffset = offset;
+        entry.keyLength = static_cast<quint32>(pending.key.size());
+        offset += static_cast<quint64>(pending.key.size()) * sizeof(char16_t);
+        entry.valueOffset = offset;
+        entry.valueLength = static_cast<quint32>(pending.value.size());
+        offset += static_cast<quint64>(pending.value.size()) * sizeof(char16_t);
+        out.append(&entry, sizeof(entry));
+    }
+    for (quint32 i : order) {
+        const Pending &pending = entries_[i];
+        out.append(pending.key.utf16(), pending.key.size() * static_cast<qsizetype>(sizeof(char16_t)));
+        out.append(pending.value.utf16(), pending.value.size() * static_cast<qsizetype>(sizeof(char16_t)));
+    }
+    if (!out.finish()) {
+        return setError(errorString, file.errorString());
+    }
+
+    header.checksum = out.checksum();
+    if (!file.seek(0) || file.write(reinterpret_cast<const char *>(&header), sizeof(header)) != sizeof(header)) {
+        return setError(errorString, file.errorString());
+    }
+    if (!file.commit()) {
+        return setError(errorString, file.errorString());
+    }
+    return true;
+}
+
+MappedHashMap::~MappedHashMap() {
+    close();
+}
+
+bool MappedHashMap::fail(const QString &message) {
+    close();
+    error_ = message;
+    return false;
+}
+
+bool MappedHashMap::open(const QString &path, bool verifyChecksum) {
+    close();
+    error_.clear();
+#if Q_BYTE_ORDER == Q_BIG_ENDIAN
+    return fail(QStringLiteral("Snapshots are little-endian; big-endian hosts are not supported"));
+#endif
+    file_.setFileName(path);
+    if (!file_.open(QIODevice::ReadOnly)) {
+        return fail(file_.errorString());
+    }
+    const quint64 fileSize = static_cast<quint64>(file_.size());
+    if (fileSize < sizeof(snapshot::Header)) {
+        return fail(QStringLiteral("%1: truncated header").arg(path));
+    }
+    data_ = file_.map(0, file_.size());
+    if (!data_) {
+        return fail(file_.errorString());
+    }
+
+    snapshot::Header header;
+    std::memcpy(&header, data_, sizeof(header));
+    if (std::memcmp(header.magic, snapshot::kMagic, sizeof(header.magic)) != 0) {
+        return fail(QStringLiteral("%1: not a hash map snapshot").arg(path));
+    }
+    if (header.version != snapshot::kVersion || header.headerSize != sizeof(snapshot::Header)) {
+        return fail(QStringLiteral("%1: unsupported snapshot version %2").arg(path).arg(header.version));
+    }
+
+    header.hashName[sizeof(header.hashName) - 1] = '\0';
+    for (const NamedHash &candidate : kHashFunctions) {
+        if (std::strcmp(candidate.name, header.hashName) == 0) hash_ = candidate.hash;
+    }
+    if (!hash_) {
+        return fail(QStringLiteral("%1: unknown hash function %2").arg(path, QString::fromLatin1(header.hashName)));
+    }
+
+    // Bound each count by the file size first so the total cannot overflow.
+    const quint64 buckets = header.bucketCount;
+    const bool countsFit = buckets >= 1 && buckets <= (1u << 30) && (buckets & (buckets - 1)) == 0
+        && header.entryCount <= fileSize / sizeof(snapshot::Entry) && header.stringBytes <= fileSize;
+    const quint64 expectedSize = sizeof(snapshot::Header) + (buckets + 1) * sizeof(quint64)
+        + header.entryCount * sizeof(snapshot::Entry) + header.stringBytes;
+    if (!countsFit || expectedSize != fileSize) {
+        return fail(QStringLiteral("%1: section sizes do not match the file size").arg(path));
+    }
+
+    const uchar *payload = data_ + sizeof(snapshot::Header);
+    bucketStarts_ = reinterpret_cast<const quint64 *>(payload);
+    entries_ = reinterpret_cast<const snapshot::Entry *>(payload + (buckets + 1) * sizeof(quint64));
+    strings_ = reinterpret_cast<const uchar *>(entries_ + header.entryCount);
+    if (bucketStarts_[0] != 0 || bucketStarts_[buckets] != header.entryCount) {
+        return fail(QStringLiteral("%1: corrupt bucket table").arg(path));
+    }
+
+    if (verifyChecksum) {
+        const qsizetype payloadSize = static_cast<qsizetype>(fileSize - sizeof(snapshot::Header));
+        quint64 checksum = 0;
+        for (qsizetype at = 0; at < payloadSize; at += snapshot::kChecksumBlock) {
+            checksum = checksumBlock(payload + at, std::min(snapshot::kChecksumBlock, payloadSize - at), checksum);
+        }
+        if (checksum != header.checksum) {
+            return fail(QStringLiteral("%1: checksum mismatch").arg(path));
+        }
+    }
+
+    entryCount_ = header.entryCount;
+    stringBytes_ = header.stringBytes;
+    bucketCount_ = static_cast<int>(buckets);
+    index_.setBucketCount(bucketCount_);
+    return true;
+}
+
+void MappedHashMap::close() {
+    if (data_) file_.unmap(data_);
+    file_.close();
+    data_ = nullptr;
+    bucketStarts_ = nullptr;
+    entries_ = nullptr;
+    strings_ = nullptr;
+    entryCount_ = 0;
+    stringBytes_ = 0;
+    bucketCount_ = 0;
+    hash_ = nullptr;
+}
+
+bool MappedHashMap::isOpen() const {
+    return data_ != nullptr;
+}
+
+QString MappedHashMap::errorString() const {
+    return error_;
+}
+
+QStringView MappedHashMap::stringAt(quint64 offset, quint32 length) const {
+    // Offsets come from the file, so they are checked on every use rather
+    // than trusted; a bad entry reads as an empty string.
+    const quint64 bytes = static_cast<quint64>(length) * sizeof(char16_t);
+    if ((offset & 1) != 0 || offset > stringBytes_ || bytes > stringBytes_ - offset) return QStringView();
+    return QStringView(reinterpret_cast<const char16_t *>(strings_ + offset), static_cast<qsizetype>(length));
+}
+
+const snapshot::Entry *MappedHashMap::findEntry(QStringView key) const {
+    if (!data_) return nullptr;
+    const quint64 hash = static_cast<quint64>(hash_(key));
+    const size_t bucket = static_cast<size_t>(index_.index(static_cast<size_t>(hash)));
+    const quint64 end = std::min(bucketStarts_[bucket + 1], entryCount_);
+    for (quint64 i = bucketStarts_[bucket]; i < end; ++i) {
+        const snapshot::Entry &entry = entries_[i];
+        if (entry.hash == hash && entry.keyLength == static_cast<quint64>(key.size())
+            && stringAt(entry.keyOffset, entry.keyLength) == key) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+std::optional<QStringView> MappedHashMap::get(QStringView key) const {
+    const snapshot::Entry *entry = findEntry(key);
+    if (!entry) return std::nullopt;
+    return stringAt(entry->valueOffset, entry->valueLength);
+}
+
+bool MappedHashMap::contains(QStringView key) const {
+    return findEntry(key) != nullptr;
+}
+
+qsizetype MappedHashMap::size() const {
+    return static_cast<qsizetype>(entryCount_);
+}
+
+qsizetype MappedHashMap::bucketCount() const {
+    return bucketCount_;
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+#include <QStringView>
+#include <QtGlobal>
+#include "hashindex.h"
+#include <optional>
+#include <vector>
+
+// Binary snapshot of a chained hash map, written by
+// BasicHashMap::saveSnapshot() and served in place by MappedHashMap.
+// Fields are little-endian and every section starts on an 8-byte boundary:
+//
+//   header   64 bytes, see snapshot::Header
+//   buckets  (bucketCount + 1) x u64; bucket b owns entries [start[b], start[b + 1])
+//   entries  entryCount x snapshot::Entry, grouped by bucket
+//   strings  UTF-16 keys and values, addressed by byte offset into the section
+//
+// Buckets follow PowerOfTwoIndex over the cached hashes, so a lookup is one
+// index computation, a contiguous run of entries and, on a hash match, one
+// key compare against the mapped bytes. The checksum covers everything
+// after the header in 64 KiB blocks chained through wyhash, which lets the
+// writer compute it while streaming the file out.
+namespace snapshot {
+
+constexpr char kMagic[8] = {'D', 'S', 'V', 'H', 'M', 'A', 'P', '\0'};
+constexpr quint32 kVersion = 1;
+constexpr qsizetype kChecksumBlock = 64 * 1024;
+
+struct Header {
+    char magic[8];
+    quint32 version;
+    quint32 headerSize;
+    char hashName[16]; // HashPolicy::name the cached hashes came from
+    quint64 entryCount;
+    quint64 bucketCount;
+    quint64 stringBytes;
+    quint64 checksum;
+};
+static_assert(sizeof(Header) == 64, "snapshot header layout");
+
+struct Entry {
+    quint64 hash;
+    quint64 keyOffset;
+    quint64 valueOffset;
+    quint32 keyLength; // UTF-16 code units
+    quint32 valueLength;
+};
+static_assert(sizeof(Entry) == 32, "snapshot entry layout");
+
+} // namespace snapshot
+
+// Collects entries and writes them out as a snapshot file, replacing the
+// target atomically. The views must stay valid until write() returns.
+class SnapshotWriter {
+public:
+    SnapshotWriter(const char *hashName, qsizetype expectedEntries);
+
+    void add(QStringView key, QStringView value, quint64 hash);
+    bool write(const QString &path, QString *errorString = nullptr) const;
+
+private:
+    struct Pending {
+        QStringView key;
+        QStringView value;
+        quint64 hash;
+    };
+
+    QByteArray hashName_;
+    std::vector<Pending> entries_;
+};
+
+// Read-only map served straight from a memory-mapped snapshot. open()
+// validates the header and section sizes only, so it takes the same time
+// for any file size and pages are faulted in by the lookups that touch
+// them; verifyChecksum reads the whole file once up front instead.
+// Snapshots are only written with unseeded hash functions (see
+// hashfunctions.h), so a file stays valid across processes.
+class MappedHashMap {
+public:
+    MappedHashMap() = default;
+    ~MappedHashMap();
+    Q_DISABLE_COPY_MOVE(MappedHashMap)
+
+    bool open(const QString &path, bool verifyChecksum = false);
+    void close();
+    bool isOpen() const;
+    QString errorString() const;
+
+    // The view points into the mapping and stays valid until close().
+    std::optional<QStringView> get(QStringView key) const;
+    bool contains(QStringView key) const;
+
+    qsizetype size() const;
+    qsizetype bucketCount() const;
+
+private:
+    using HashFunction = size_t (*)(QStringView);
+
+    const snapshot::Entry *findEntry(QStringView key) const;
+    QStringView stringAt(quint64 offset, quint32 length) const;
+    bool fail(const QString &message);
+
+    QFile file_;
+    uchar *data_ = nullptr;
+    const quint64 *bucketStarts_ = nullptr;
+    const snapshot::Entry *entries_ = nullptr;
+    const uchar *strings_ = nullptr;
+    quint64 entryCount_ = 0;
+    quint64 stringBytes_ = 0;
+    int bucketCount_ = 0;
+    PowerOfTwoIndex index_;
+    HashFunction hash_ = nullptr;
+    QString error_;
+};
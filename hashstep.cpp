@@ -0,0 +1,126 @@
+#include "hashstep.h"
+
+void HashStepTrace::clear() {
+    steps_.clear();
+    strings_.clear();
+}
+
+HashStep &HashStepTrace::record(HashStepOp op) {
+    steps_.emplace_back();
+    HashStep &step = steps_.back();
+    step.op = op;
+    return step;
+}
+
+int HashStepTrace::intern(const QString &text) {
+    // QString is implicitly shared: this only bumps a reference count.
+    strings_.push_back(text);
+    return static_cast<int>(strings_.size()) - 1;
+}
+
+QString HashStepTrace::stringAt(int ref) const {
+    if (ref < 0 || ref >= static_cast<int>(strings_.size())) return QString();
+    return strings_[static_cast<size_t>(ref)];
+}
+
+QString HashStepTrace::format(int i) const {
+    const HashStep &s = at(i);
+    switch (s.op) {
+    case HashStepOp::ComputeHash:
+        return QStringLiteral("Compute hash(%1) = %2").arg(stringAt(s.keyRef)).arg(static_cast<qulonglong>(s.hash));
+    case HashStepOp::ComputeIndex:
+        return QStringLiteral("Index = hash % %1 = %2").arg(s.count).arg(s.bucket);
+    case HashStepOp::ComputeIndexMask:
+        return QStringLiteral("Index = mix(hash) & %1 = %2").arg(s.count - 1).arg(s.bucket);
+    case HashStepOp::ComputeIndexFastMod:
+        return QStringLiteral("Index = fastmod(hash, %1) = %2").arg(s.count).arg(s.bucket);
+    case HashStepOp::ComputeIndexRange:
+        return QStringLiteral("Index = (hash32 × %1) >> 32 = %2").arg(s.count).arg(s.bucket);
+    case HashStepOp::VisitBucket:
+        return QStringLiteral("Visit bucket %1").arg(s.bucket);
+    case HashStepOp::CompareKeys:
+        return QStringLiteral("Compare keys: %1 == %2 ? %3")
+            .arg(stringAt(s.keyRef), stringAt(s.otherRef), s.matched ? QStringLiteral("Yes") : QStringLiteral("No"));
+    case HashStepOp::HashMismatch:
+        return QStringLiteral("Cached hash of %1 (%2) differs → skip key compare")
+            .arg(stringAt(s.keyRef)).arg(static_cast<qulonglong>(s.hash));
+    case HashStepOp::FilterAbsent:
+        return QStringLiteral("Bloom filter says absent → skip bucket");
+    case HashStepOp::TraverseNext:
+        return QStringLiteral("Traverse next in chain");
+    case HashStepOp::UpdateValue:
+        return QStringLiteral("Key exists → update value: %1 → %2").arg(stringAt(s.keyRef), stringAt(s.otherRef));
+    case HashStepOp::DuplicateKey:
+        return QStringLiteral("Key exists → no insert (duplicate)");
+    case HashStepOp::AppendNode:
+        return QStringLiteral("Append new node to bucket %1").arg(s.bucket);
+    case HashStepOp::NewSize:
+        return QStringLiteral("New size = %1, load factor = %2").arg(s.count).arg(s.loadFactor, 0, 'f', 2);
+    case HashStepOp::BulkLoad:
+        return QStringLiteral("Bulk %1 of %2 pairs → %3 new keys")
+            .arg(s.matched ? QStringLiteral("put") : QStringLiteral("insert")).arg(s.bucket).arg(s.count);
+    case HashStepOp::Found:
+        return QStringLiteral("Found → return value %1").arg(stringAt(s.keyRef));
+    case HashStepOp::NotFound:
+        return QStringLiteral("Reached end of chain → not found");
+    case HashStepOp::TableEmpty:
+        return QStringLiteral("Table is empty → not found");
+    case HashStepOp::EraseEmpty:
+        return QStringLiteral("Table is empty → nothing to erase");
+    case HashStepOp::Erased:
+        return QStringLiteral("Erased node. New size = %1, load factor = %2").arg(s.count).arg(s.loadFactor, 0, 'f', 2);
+    case HashStepOp::EraseNotFound:
+        return QStringLiteral("Reached end of chain → key not found");
+    case HashStepOp::Cleared:
+        return QStringLiteral("Cleared all buckets");
+    case HashStepOp::GrowRehash:
+        return QStringLiteral("Load factor %1 exceeds %2 → rehash to %3 buckets")
+            .arg(s.loadFactor, 0, 'f', 2)
+            .arg(s.loadFactor2, 0, 'f', 2)
+            .arg(s.bucket);
+    case HashStepOp::ShrinkRehash:
+        return QStringLiteral("Load factor %1 below %2 → shrink to %3 buckets")
+            .arg(s.loadFactor, 0, 'f', 2)
+            .arg(s.loadFactor2, 0, 'f', 2)
+            .arg(s.bucket);
+    case HashStepOp::Rehashing:
+        return QStringLiteral("Rehashing from %1 to %2 buckets").arg(s.count).arg(s.bucket);
+    case HashStepOp::MoveNode:
+        return QStringLiteral("Move (%1,%2) → bucket %3").arg(stringAt(s.keyRef), stringAt(s.otherRef)).arg(s.bucket);
+    case HashStepOp::ReserveRehash:
+        return QStringLiteral("Reserve(%1) → rehash to %2 buckets").arg(s.count).arg(s.bucket);
+    case HashStepOp::MigrateStart:
+        return QStringLiteral("Start incremental rehash: %1 → %2 buckets").arg(s.count).arg(s.bucket);
+    case HashStepOp::MigrateBuckets:
+        return QStringLiteral("Migrated %1 of %2 old buckets").arg(s.bucket).arg(s.count);
+    case HashStepOp::MigrateDone:
+        return QStringLiteral("Incremental rehash complete, old table released");
+    case HashStepOp::VisitOldBucket:
+        return QStringLiteral("Visit old bucket %1 (not migrated yet)").arg(s.bucket);
+    case HashStepOp::ProbeSlot:
+        return QStringLiteral("Probe slot %1 (distance %2)").arg(s.bucket).arg(s.count);
+    case HashStepOp::EmptySlot:
+        return QStringLiteral("Slot %1 is empty").arg(s.bucket);
+    case HashStepOp::PlaceInSlot:
+        return QStringLiteral("Place entry in slot %1 (distance %2)").arg(s.bucket).arg(s.count);
+    case HashStepOp::Displace:
+        return QStringLiteral("Robin Hood: evict %1 from slot %2 (distance %3) and carry it forward")
+            .arg(stringAt(s.keyRef)).arg(s.bucket).arg(s.count);
+    case HashStepOp::ProbeStop:
+        return QStringLiteral("Slot %1 holds a closer entry than distance %2 → not found").arg(s.bucket).arg(s.count);
+    case HashStepOp::ShiftBack:
+        return QStringLiteral("Shift slot %1 back to slot %2").arg(s.bucket).arg(s.count);
+    case HashStepOp::ProbeGroup:
+        return QStringLiteral("Probe group %1 for tag 0x%2: candidates %3")
+            .arg(s.bucket)
+            .arg(static_cast<qulonglong>(s.hash), 2, 16, QLatin1Char('0'))
+            .arg(static_cast<uint>(s.count), 16, 2, QLatin1Char('0'));
+    case HashStepOp::GroupHasEmpty:
+        return QStringLiteral("Group %1 has an empty slot → stop probing").arg(s.bucket);
+    case HashStepOp::ClaimSlot:
+        return QStringLiteral("Claim slot %1, control byte = 0x%2")
+            .arg(s.bucket)
+            .arg(static_cast<qulonglong>(s.hash), 2, 16, QLatin1Char('0'));
+    }
+    return QString();
+}
@@ -0,0 +1,159 @@
+#pragma once
+
+#include <QString>
+#include <QtGlobal>
+#include <vector>
+
+// Trace policies for the hash map engines. StepTrace records structured step
+// events for the visualizer; NoTrace turns every trace call into a no-op so
+// the operations compile down to plain hashing code.
+struct StepTrace {
+    static constexpr bool enabled = true;
+};
+
+struct NoTrace {
+    static constexpr bool enabled = false;
+};
+
+// Kinds of steps a hash map operation can record.
+enum class HashStepOp : quint8 {
+    ComputeHash,         // hash of keyRef
+    ComputeIndex,        // hash % count = bucket
+    ComputeIndexMask,    // mix(hash) & (count - 1) = bucket
+    ComputeIndexFastMod, // fastmod(hash, count) = bucket
+    ComputeIndexRange,   // (hash32 * count) >> 32 = bucket
+    VisitBucket,         // bucket
+    CompareKeys,         // keyRef (stored) vs otherRef (probe), matched
+    HashMismatch,        // cached hash of keyRef differs from the probe's → skip
+    FilterAbsent,        // Bloom filter lacks a bit for hash → definitely absent
+    TraverseNext,
+    UpdateValue,         // keyRef (old value) → otherRef (new value)
+    DuplicateKey,
+    AppendNode,          // bucket
+    NewSize,             // count = size, loadFactor
+    BulkLoad,            // bucket = pairs given, count = new keys, matched = assign existing;
+                         // followed by one Rehashing step if the load resized the table
+    Found,               // keyRef = value
+    NotFound,
+    TableEmpty,
+    EraseEmpty,
+    Erased,              // count = size, loadFactor
+    EraseNotFound,
+    Cleared,
+    GrowRehash,          // loadFactor exceeds loadFactor2 (max) → bucket buckets
+    ShrinkRehash,        // loadFactor below loadFactor2 (min) → bucket buckets
+    Rehashing,           // count = old bucket count → bucket = new bucket count
+    MoveNode,            // (keyRef, otherRef) → bucket
+    ReserveRehash,       // count = expected elements → bucket buckets
+    MigrateStart,        // incremental rehash from count to bucket buckets
+    MigrateBuckets,      // bucket of count old buckets migrated so far
+    MigrateDone,
+    VisitOldBucket,      // bucket in the not-yet-migrated old table
+    // Open addressing (Robin Hood)
+    ProbeSlot,           // bucket = slot, count = probe distance
+    EmptySlot,           // bucket = slot
+    PlaceInSlot,         // bucket = slot, count = probe distance
+    Displace,            // keyRef evicted from bucket (distance count) and carried on
+    ProbeStop,           // resident at bucket is closer to home than count → absent
+    ShiftBack,           // entry at bucket moves back to slot count
+    // Swiss table
+    ProbeGroup,          // bucket = group, hash = 7-bit tag, count = candidate mask
+    GroupHasEmpty,       // bucket = group contains an empty slot → absent
+    ClaimSlot,           // bucket = slot, hash = 7-bit tag written to control byte
+};
+
+// One recorded step. Strings are referenced by handle into the owning
+// HashStepTrace so recording never formats or allocates text.
+struct HashStep {
+    HashStepOp op = HashStepOp::TraverseNext;
+    bool matched = false;
+    int bucket = -1;
+    int count = 0;
+    float loadFactor = 0.0f;
+    float loadFactor2 = 0.0f;
+    quint64 hash = 0;
+    int keyRef = -1;
+    int otherRef = -1;
+};
+
+// Reusable buffer of step records for the last operation. clear() keeps the
+// capacity of both buffers, so steady-state recording does not allocate.
+// Text is produced on demand by format().
+class HashStepTrace {
+public:
+    void clear();
+
+    HashStep &record(HashStepOp op);
+    int intern(const QString &text);
+
+    int size() const { return static_cast<int>(steps_.size()); }
+    bool isEmpty() const { return steps_.empty(); }
+    const HashStep &at(int i) const { return steps_[static_cast<size_t>(i)]; }
+    QString format(int i) const;
+
+private:
+    QString stringAt(int ref) const;
+
+    std::vector<HashStep> steps_;
+    std::vector<QString> strings_;
+};
+
+// Per-engine front end to HashStepTrace that compiles away under NoTrace.
+template <typename TracePolicy>
+class StepRecorder {
+public:
+    const HashStepTrace &steps() const { return steps_; }
+
+    inline void clear() {
+        if constexpr (TracePolicy::enabled) {
+            steps_.clear();
+        }
+    }
+
+    // Records a step; with NoTrace the filler is never invoked.
+    inline void add(HashStepOp op) {
+        if constexpr (TracePolicy::enabled) {
+            if (!suspended_) steps_.record(op);
+        }
+    }
+
+    template <typename Fill>
+    inline void add(HashStepOp op, Fill &&fill) {
+        if constexpr (TracePolicy::enabled) {
+            if (!suspended_) fill(steps_.record(op));
+        }
+    }
+
+    // Bulk operations suspend per-element recording and add a summary.
+    inline void setSuspended(bool suspended) {
+        if constexpr (TracePolicy::enabled) {
+            suspended_ = suspended;
+        } else {
+            Q_UNUSED(suspended);
+        }
+    }
+
+    // Returns a trace handle for text, or -1 when tracing is disabled.
+    inline int ref(const QString &text) {
+        if constexpr (TracePolicy::enabled) {
+            return suspended_ ? -1 : steps_.intern(text);
+        } else {
+            Q_UNUSED(text);
+            return -1;
+        }
+    }
+
+    // Probe keys arrive as views; only the tracing build copies the text.
+    inline int ref(QStringView text) {
+        if constexpr (TracePolicy::enabled) {
+            return suspended_ ? -1 : steps_.intern(text.toString());
+        } else {
+            Q_UNUSED(text);
+            return -1;
+        }
+    }
+
+private:
+    HashStepTrace steps_;
+    bool suspended_ = false;
+};
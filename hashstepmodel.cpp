@@ -0,0 +1,39 @@
+#include "hashstepmodel.h"
+
+HashStepModel::HashStepModel(QObject *parent)
+    : QAbstractListModel(parent)
+    , trace(nullptr)
+{
+}
+
+void HashStepModel::setTrace(const HashStepTrace *newTrace)
+{
+    beginResetModel();
+    trace = newTrace;
+    endResetModel();
+}
+
+void HashStepModel::refresh()
+{
+    beginResetModel();
+    endResetModel();
+}
+
+int HashStepModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid() || !trace) {
+        return 0;
+    }
+    return trace->size();
+}
+
+QVariant HashStepModel::data(const QModelIndex &index, int role) const
+{
+    if (!trace || !index.isValid() || index.row() >= trace->size()) {
+        return QVariant();
+    }
+    if (role == Qt::DisplayRole) {
+        return trace->format(index.row());
+    }
+    return QVariant();
+}
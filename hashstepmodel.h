@@ -0,0 +1,26 @@
+#ifndef HASHSTEPMODEL_H
+#define HASHSTEPMODEL_H
+
+#include <QAbstractListModel>
+#include "hashstep.h"
+
+// List model over a HashStepTrace. Rows are formatted only when a view asks
+// for them, so large traces (e.g. a rehash) stay cheap to display.
+class HashStepModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    explicit HashStepModel(QObject *parent = nullptr);
+
+    void setTrace(const HashStepTrace *trace);
+    void refresh();
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+private:
+    const HashStepTrace *trace;
+};
+
+#endif // HASHSTEPMODEL_H
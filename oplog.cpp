@@ -0,0 +1,178 @@
+#include "oplog.h"
+
+#include <QFile>
+#include <QSaveFile>
+#include <QtEndian>
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace {
+
+constexpr char kMagic[8] = {'D', 'S', 'V', 'O', 'P', 'L', 'O', 'G'};
+constexpr quint32 kVersion = 1;
+constexpr qsizetype kHeaderSize = 24;
+
+bool hasKey(LoggedOp op) { return op != LoggedOp::Clear; }
+bool hasValue(LoggedOp op) { return op == LoggedOp::Insert || op == LoggedOp::Put; }
+
+void appendVarint(QByteArray &out, quint64 value) {
+    while (value >= 0x80) {
+        out.append(static_cast<char>((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    out.append(static_cast<char>(value));
+}
+
+void appendString(QByteArray &out, QStringView text) {
+    const QByteArray utf8 = text.toUtf8();
+    appendVarint(out, static_cast<quint64>(utf8.size()));
+    out.append(utf8);
+}
+
+// Sequential reader over encoded records. Every read checks the bounds, so
+// a truncated or corrupt file fails instead of reading past the buffer.
+class RecordReader {
+public:
+    RecordReader(const char *data, qsizetype size) : p_(data), end_(data + size) {}
+
+    bool atEnd() const { return p_ == end_; }
+
+    bool readOp(LoggedOp &op) {
+        if (p_ == end_ || static_cast<quint8>(*p_) > static_cast<quint8>(LoggedOp::Clear)) return false;
+        op = static_cast<LoggedOp>(*p_++);
+        return true;
+    }
+
+    bool readString(QString *text) {
+        quint64 length = 0;
+        for (int shift = 0;; shift += 7) {
+            if (p_ == end_ || shift > 63) return false;
+            const quint8 byte = static_cast<quint8>(*p_++);
+            length |= static_cast<quint64>(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) break;
+        }
+        if (length > static_cast<quint64>(end_ - p_)) return false;
+        if (text) *text = QString::fromUtf8(p_, static_cast<qsizetype>(length));
+        p_ += length;
+        return true;
+    }
+
+    // Reads one record; a null out parameter only validates it.
+    bool read(LoggedOperation *operation) {
+        LoggedOp op;
+        if (!readOp(op)) return false;
+        if (operation) operation->op = op;
+        if (hasKey(op) && !readString(operation ? &operation->key : nullptr)) return false;
+        if (hasValue(op) && !readString(operation ? &operation->value : nullptr)) return false;
+        return true;
+    }
+
+private:
+    const char *p_;
+    const char *end_;
+};
+
+bool setError(QString *errorString, const QString &message) {
+    if (errorString) *errorString = message;
+    return false;
+}
+
+} // namespace
+
+void OperationLog::append(LoggedOp op, QStringView key, QStringView value) {
+    records_.append(static_cast<char>(op));
+    if (hasKey(op)) appendString(records_, key);
+    if (hasValue(op)) appendString(records_, value);
+    ++count_;
+}
+
+void OperationLog::clear() {
+    records_.clear();
+    count_ = 0;
+}
+
+qsizetype OperationLog::size() const {
+    return count_;
+}
+
+bool OperationLog::isEmpty() const {
+    return count_ == 0;
+}
+
+qsizetype OperationLog::byteSize() const {
+    return kHeaderSize + records_.size();
+}
+
+void OperationLog::setInitialBucketCount(int count) {
+    initialBucketCount_ = static_cast<quint32>(std::max(0, count));
+}
+
+int OperationLog::initialBucketCount() const {
+    return static_cast<int>(initialBucketCount_);
+}
+
+std::vector<LoggedOperation> OperationLog::operations() const {
+    std::vector<LoggedOperation> operations(static_cast<size_t>(count_));
+    RecordReader reader(records_.constData(), records_.size());
+    for (LoggedOperation &operation : operations) {
+        (void)reader.read(&operation); // validated when appended or loaded
+    }
+    return operations;
+}
+
+bool OperationLog::save(const QString &path, QString *errorString) const {
+    char header[kHeaderSize] = {};
+    std::memcpy(header, kMagic, sizeof(kMagic));
+    qToLittleEndian<quint32>(kVersion, header + 8);
+    qToLittleEndian<quint32>(initialBucketCount_, header + 12);
+    qToLittleEndian<quint64>(static_cast<quint64>(count_), header + 16);
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return setError(errorString, file.errorString());
+    }
+    if (file.write(header, kHeaderSize) != kHeaderSize
+        || file.write(records_.constData(), records_.size()) != records_.size()) {
+        return setError(errorString, file.errorString());
+    }
+    if (!file.commit()) {
+        return setError(errorString, file.errorString());
+    }
+    return true;
+}
+
+bool OperationLog::load(const QString &path, QString *errorString) {
+    clear();
+    initialBucketCount_ = 0;
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return setError(errorString, file.errorString());
+    }
+    QByteArray data = file.readAll();
+    if (data.size() < kHeaderSize || std::memcmp(data.constData(), kMagic, sizeof(kMagic)) != 0) {
+        return setError(errorString, QStringLiteral("%1: not an operation log").arg(path));
+    }
+    if (qFromLittleEndian<quint32>(data.constData() + 8) != kVersion) {
+        return setError(errorString, QStringLiteral("%1: unsupported operation log version").arg(path));
+    }
+    const quint64 count = qFromLittleEndian<quint64>(data.constData() + 16);
+
+    RecordReader reader(data.constData() + kHeaderSize, data.size() - kHeaderSize);
+    quint64 parsed = 0;
+    while (!reader.atEnd()) {
+        if (!reader.read(nullptr)) {
+            return setError(errorString, QStringLiteral("%1: corrupt record %2").arg(path).arg(parsed));
+        }
+        ++parsed;
+    }
+    if (parsed != count) {
+        return setError(errorString, QStringLiteral("%1: expected %2 records, found %3").arg(path).arg(count).arg(parsed));
+    }
+    records_ = data.mid(kHeaderSize);
+    count_ = static_cast<qsizetype>(count);
+    // Written as zero before the field existed, which reads as unknown.
+    initialBucketCount_ = std::min<quint32>(qFromLittleEndian<quint32>(data.constData() + 12),
+                                            static_cast<quint32>(std::numeric_limits<int>::max()));
+    return true;
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QString>
+#include <QStringView>
+#include <QtGlobal>
+#include "hashmetrics.h"
+#include <vector>
+
+// Operations a HashMap session is made of, in the order they were issued.
+enum class LoggedOp : quint8 {
+    Insert,
+    Put,
+    Get,
+    Erase,
+    Clear,
+};
+
+struct LoggedOperation {
+    LoggedOp op = LoggedOp::Get;
+    QString key;   // empty for Clear
+    QString value; // set for Insert and Put only
+};
+
+// Binary operation log. Records are encoded as they are appended, so
+// recording is one buffer append per operation and saving writes the
+// buffer out as it is. File layout, little-endian:
+//
+//   header   24 bytes: magic "DSVOPLOG", u32 version, u32 initial bucket
+//            count (0 = unknown), u64 record count
+//   records  one op byte, then for every op but Clear a varint byte length
+//            and the UTF-8 key, then for Insert and Put the value the same way
+//
+// A log replays against any engine configuration with replayOperations().
+class OperationLog {
+public:
+    void append(LoggedOp op, QStringView key = {}, QStringView value = {});
+    void clear();
+
+    qsizetype size() const;
+    bool isEmpty() const;
+    qsizetype byteSize() const;
+
+    // Bucket count of the engine the session started on, so a replay can
+    // start from the same table; 0 if unknown. Kept by clear().
+    void setInitialBucketCount(int count);
+    int initialBucketCount() const;
+
+    // Decodes every record; done once before replaying so decoding stays
+    // out of the timed loop.
+    std::vector<LoggedOperation> operations() const;
+
+    bool save(const QString &path, QString *errorString = nullptr) const;
+    // Replaces the log with the file's contents. On failure the log is left
+    // empty and *errorString says why.
+    bool load(const QString &path, QString *errorString = nullptr);
+
+private:
+    QByteArray records_;
+    qsizetype count_ = 0;
+    quint32 initialBucketCount_ = 0;
+};
+
+// Runs operations against map at full speed and returns the elapsed
+// nanoseconds. With a recorder, operations are counted, gets are counted as
+// hits or misses and one operation in the recorder's sample interval is
+// timed; chain visits are not visible from here and stay zero. Map needs
+// the insert/put/get/erase/clear surface all engines share.
+template <typename Map>
+qint64 replayOperations(Map &map, const std::vector<LoggedOperation> &operations,
+                        HashMetricsRecorder *recorder = nullptr) {
+    QElapsedTimer timer;
+    timer.start();
+    for (const LoggedOperation &operation : operations) {
+        switch (operation.op) {
+        case LoggedOp::Insert: {
+            const HashMetricsRecorder::OperationTimer sample(recorder, HashOperation::Insert);
+            (void)map.insert(operation.key, operation.value);
+            break;
+        }
+        case LoggedOp::Put: {
+            const HashMetricsRecorder::OperationTimer sample(recorder, HashOperation::Put);
+            map.put(operation.key, operation.value);
+            break;
+        }
+        case LoggedOp::Get: {
+            bool hit = false;
+            {
+                const HashMetricsRecorder::OperationTimer sample(recorder, HashOperation::Get);
+                hit = map.get(operation.key).has_value();
+            }
+            if (recorder) recorder->countLookup(hit, 0);
+            break;
+        }
+        case LoggedOp::Erase: {
+            const HashMetricsRecorder::OperationTimer sample(recorder, HashOperation::Erase);
+            (void)map.erase(operation.key);
+            break;
+        }
+        case LoggedOp::Clear:
+            map.clear();
+            break;
+        }
+    }
+    return timer.nsecsElapsed();
+}
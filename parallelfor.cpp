@@ -0,0 +1,42 @@
+#include "parallelfor.h"
+
+#include <QSemaphore>
+#include <QThreadPool>
+#include <algorithm>
+#include <atomic>
+
+namespace {
+
+constexpr int kChunksPerThread = 4;
+
+} // namespace
+
+void parallelFor(int chunkCount, const std::function<void(int)> &chunk) {
+    if (chunkCount <= 0) return;
+    std::atomic<int> next{0};
+    const auto drain = [&] {
+        for (int i = next.fetch_add(1, std::memory_order_relaxed); i < chunkCount;
+             i = next.fetch_add(1, std::memory_order_relaxed)) {
+            chunk(i);
+        }
+    };
+
+    QThreadPool *pool = QThreadPool::globalInstance();
+    QSemaphore finished;
+    const int wanted = std::min(chunkCount, pool->maxThreadCount()) - 1; // the caller works too
+    int helpers = 0;
+    while (helpers < wanted && pool->tryStart([&] {
+        drain();
+        finished.release();
+    })) {
+        ++helpers;
+    }
+    drain();
+    finished.acquire(helpers);
+}
+
+int parallelChunkCount(size_t items) {
+    const size_t chunks = static_cast<size_t>(std::max(1, QThreadPool::globalInstance()->maxThreadCount()))
+        * kChunksPerThread;
+    return static_cast<int>(std::max<size_t>(1, std::min(items, chunks)));
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+// Runs chunk(0) ... chunk(chunkCount - 1) on QThreadPool::globalInstance()
+// and the calling thread, returning once every chunk has finished. Chunks
+// are handed out dynamically, so uneven chunks still balance. Helpers are
+// only started on idle pool threads, which means a call from inside a pool
+// task cannot deadlock: at worst the caller runs every chunk itself.
+void parallelFor(int chunkCount, const std::function<void(int)> &chunk);
+
+// A few chunks per pool thread, and never more than there are items.
+int parallelChunkCount(size_t items);
@@ -0,0 +1,191 @@
+#include "readoptimizedhashmap.h"
+
+#include <QHashFunctions>
+#include <QMutexLocker>
+#include <algorithm>
+
+ReadOptimizedHashMap::Table::Table(int count)
+    : bucketCount(PowerOfTwoIndex::roundBucketCount(std::max(1, count))),
+      heads(new std::atomic<Node *>[static_cast<size_t>(bucketCount)]) {
+    index.setBucketCount(bucketCount);
+    for (int i = 0; i < bucketCount; ++i) {
+        heads[i].store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+ReadOptimizedHashMap::ReadOptimizedHashMap(int initialBucketCount, float maxLoadFactor)
+    : table_(new Table(initialBucketCount)),
+      maxLoadFactor_(maxLoadFactor) {
+}
+
+ReadOptimizedHashMap::~ReadOptimizedHashMap() {
+    destroyTable(table_.load(std::memory_order_relaxed));
+}
+
+void ReadOptimizedHashMap::destroyTable(void *table) {
+    Table *t = static_cast<Table *>(table);
+    for (int i = 0; i < t->bucketCount; ++i) {
+        Node *node = t->heads[i].load(std::memory_order_relaxed);
+        while (node) {
+            Node *next = node->next.load(std::memory_order_relaxed);
+            delete node;
+            node = next;
+        }
+    }
+    delete t;
+}
+
+std::optional<QString> ReadOptimizedHashMap::get(QStringView key) const {
+    const EpochReclaimer::Guard guard = reclaimer_.pin();
+    const Table *table = table_.load(std::memory_order_acquire);
+    const size_t hash = static_cast<size_t>(qHash(key));
+    const Node *node = table->heads[table->index.index(hash)].load(std::memory_order_acquire);
+    for (; node; node = node->next.load(std::memory_order_acquire)) {
+        if (node->hash == hash && node->key == key) {
+            return node->value;
+        }
+    }
+    return std::nullopt;
+}
+
+bool ReadOptimizedHashMap::contains(QStringView key) const {
+    const EpochReclaimer::Guard guard = reclaimer_.pin();
+    const Table *table = table_.load(std::memory_order_acquire);
+    const size_t hash = static_cast<size_t>(qHash(key));
+    const Node *node = table->heads[table->index.index(hash)].load(std::memory_order_acquire);
+    for (; node; node = node->next.load(std::memory_order_acquire)) {
+        if (node->hash == hash && node->key == key) {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::atomic<ReadOptimizedHashMap::Node *> *ReadOptimizedHashMap::findLink(Table *table, size_t hash, QStringView key) {
+    // Writers are serialized, so their own loads can be relaxed.
+    std::atomic<Node *> *link = &table->heads[table->index.index(hash)];
+    for (Node *node = link->load(std::memory_order_relaxed); node; node = link->load(std::memory_order_relaxed)) {
+        if (node->hash == hash && node->key == key) {
+            return link;
+        }
+        link = &node->next;
+    }
+    return nullptr;
+}
+
+bool ReadOptimizedHashMap::insertLocked(const QString &key, const QString &value, bool assignIfExists) {
+    Table *table = table_.load(std::memory_order_relaxed);
+    const size_t hash = static_cast<size_t>(qHash(key));
+    if (std::atomic<Node *> *link = findLink(table, hash, key)) {
+        if (assignIfExists) {
+            // Readers may be reading the old value; swap in a copy instead
+            // of writing the QString in place.
+            Node *old = link->load(std::memory_order_relaxed);
+            Node *fresh = new Node(old->key, value, hash, old->next.load(std::memory_order_relaxed));
+            link->store(fresh, std::memory_order_release);
+            reclaimer_.retire(old);
+        }
+        return false;
+    }
+
+    std::atomic<Node *> &head = table->heads[table->index.index(hash)];
+    Node *fresh = new Node(key, value, hash, head.load(std::memory_order_relaxed));
+    head.store(fresh, std::memory_order_release);
+    numElements_.store(numElements_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    return true;
+}
+
+bool ReadOptimizedHashMap::insert(const QString &key, const QString &value) {
+    QMutexLocker locker(&writeMutex_);
+    maybeGrowLocked();
+    return insertLocked(key, value, /*assignIfExists=*/false);
+}
+
+void ReadOptimizedHashMap::put(const QString &key, const QString &value) {
+    QMutexLocker locker(&writeMutex_);
+    maybeGrowLocked();
+    (void)insertLocked(key, value, /*assignIfExists=*/true);
+}
+
+bool ReadOptimizedHashMap::erase(QStringView key) {
+    QMutexLocker locker(&writeMutex_);
+    Table *table = table_.load(std::memory_order_relaxed);
+    std::atomic<Node *> *link = findLink(table, static_cast<size_t>(qHash(key)), key);
+    if (!link) return false;
+
+    // A reader standing on the unlinked node still sees its next pointer,
+    // which stays valid until the node is reclaimed.
+    Node *node = link->load(std::memory_order_relaxed);
+    link->store(node->next.load(std::memory_order_relaxed), std::memory_order_release);
+    reclaimer_.retire(node);
+    numElements_.store(numElements_.load(std::memory_order_relaxed) - 1, std::memory_order_relaxed);
+    return true;
+}
+
+void ReadOptimizedHashMap::clear() {
+    QMutexLocker locker(&writeMutex_);
+    Table *old = table_.load(std::memory_order_relaxed);
+    table_.store(new Table(old->bucketCount), std::memory_order_release);
+    numElements_.store(0, std::memory_order_relaxed);
+    reclaimer_.retire(old, &ReadOptimizedHashMap::destroyTable);
+}
+
+void ReadOptimizedHashMap::rehashLocked(int newBucketCount) {
+    // Relinking published nodes would move them between chains under a
+    // reader's feet, so the new table gets its own copies (QString copies
+    // only bump reference counts) and the old one is retired whole.
+    Table *old = table_.load(std::memory_order_relaxed);
+    Table *fresh = new Table(newBucketCount);
+    for (int i = 0; i < old->bucketCount; ++i) {
+        for (Node *node = old->heads[i].load(std::memory_order_relaxed); node;
+             node = node->next.load(std::memory_order_relaxed)) {
+            std::atomic<Node *> &head = fresh->heads[fresh->index.index(node->hash)];
+            head.store(new Node(node->key, node->value, node->hash, head.load(std::memory_order_relaxed)),
+                       std::memory_order_relaxed);
+        }
+    }
+    table_.store(fresh, std::memory_order_release);
+    reclaimer_.retire(old, &ReadOptimizedHashMap::destroyTable);
+}
+
+void ReadOptimizedHashMap::maybeGrowLocked() {
+    const Table *table = table_.load(std::memory_order_relaxed);
+    const float projected = (static_cast<float>(size()) + 1.0f) / static_cast<float>(table->bucketCount);
+    if (projected > maxLoadFactor_) {
+        rehashLocked(table->bucketCount * 2);
+    }
+}
+
+void ReadOptimizedHashMap::rehash(int newBucketCount) {
+    QMutexLocker locker(&writeMutex_);
+    rehashLocked(newBucketCount);
+}
+
+void ReadOptimizedHashMap::reserve(int expectedElements) {
+    if (expectedElements <= 0) return;
+    QMutexLocker locker(&writeMutex_);
+    const float desiredLoad = std::min(0.6f, maxLoadFactor_); // target below max for headroom
+    const int requiredBuckets = PowerOfTwoIndex::roundBucketCount(
+        std::max(1, static_cast<int>(expectedElements / desiredLoad)));
+    if (requiredBuckets > table_.load(std::memory_order_relaxed)->bucketCount) {
+        rehashLocked(requiredBuckets);
+    }
+}
+
+int ReadOptimizedHashMap::size() const {
+    return numElements_.load(std::memory_order_relaxed);
+}
+
+int ReadOptimizedHashMap::bucketCount() const {
+    const EpochReclaimer::Guard guard = reclaimer_.pin();
+    return table_.load(std::memory_order_acquire)->bucketCount;
+}
+
+float ReadOptimizedHashMap::loadFactor() const {
+    return static_cast<float>(size()) / static_cast<float>(bucketCount());
+}
+
+int ReadOptimizedHashMap::pendingReclaims() const {
+    QMutexLocker locker(&writeMutex_);
+    return reclaimer_.pendingCount();
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <QMutex>
+#include <QString>
+#include <QStringView>
+#include "epochreclaimer.h"
+#include "hashindex.h"
+#include <atomic>
+#include <memory>
+#include <optional>
+
+// Chained HashMap for read-mostly workloads: get() and contains() traverse
+// chains without taking any lock, while writers serialize on one mutex.
+//
+// Published nodes are immutable apart from their next link. Writers make
+// every change visible with a single release store: a new node is fully
+// built before it is linked, put() on an existing key links a replacement
+// node, and erase() unlinks. Rehash and clear() build a new bucket table
+// and swap the table pointer. Unlinked nodes and retired tables go through
+// an EpochReclaimer, so a reader that is still walking them never touches
+// freed memory. No step trace is recorded; there is no single "last
+// operation" once readers run concurrently.
+class ReadOptimizedHashMap {
+public:
+    explicit ReadOptimizedHashMap(int initialBucketCount = 16, float maxLoadFactor = 0.75f);
+    ~ReadOptimizedHashMap();
+    Q_DISABLE_COPY_MOVE(ReadOptimizedHashMap)
+
+    // Writers. Safe to call from any thread; they serialize on writeMutex_.
+    bool insert(const QString &key, const QString &value);
+    void put(const QString &key, const QString &value);
+    bool erase(QStringView key);
+    void clear();
+    void rehash(int newBucketCount);
+    void reserve(int expectedElements);
+
+    // Lock-free readers.
+    std::optional<QString> get(QStringView key) const;
+    bool contains(QStringView key) const;
+
+    int size() const;
+    int bucketCount() const;
+    float loadFactor() const;
+
+    // Objects waiting for readers to drain before they are freed.
+    int pendingReclaims() const;
+
+private:
+    struct Node {
+        Node(QString k, QString v, size_t h, Node *n)
+            : key(std::move(k)), value(std::move(v)), hash(h), next(n) {}
+        const QString key;
+        const QString value;
+        const size_t hash;
+        std::atomic<Node *> next;
+    };
+
+    struct Table {
+        explicit Table(int count);
+        PowerOfTwoIndex index;
+        int bucketCount;
+        std::unique_ptr<std::atomic<Node *>[]> heads;
+    };
+
+    std::atomic<Table *> table_;
+    std::atomic<int> numElements_ {0};
+    float maxLoadFactor_ = 0.75f;
+
+    mutable QMutex writeMutex_;
+    mutable EpochReclaimer reclaimer_;
+
+    // Writer helpers; callers hold writeMutex_.
+    std::atomic<Node *> *findLink(Table *table, size_t hash, QStringView key);
+    bool insertLocked(const QString &key, const QString &value, bool assignIfExists);
+    void rehashLocked(int newBucketCount);
+    void maybeGrowLocked();
+
+    static void destroyTable(void *table);
+};
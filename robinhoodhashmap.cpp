@@ -0,0 +1,315 @@
+#include "robinhoodhashmap.h"
+
+#include <algorithm>
+#include <utility>
+
+template <typename TracePolicy>
+BasicRobinHoodHashMap<TracePolicy>::BasicRobinHoodHashMap(int initialSlotCount, float maxLoadFactor)
+    : entries_(static_cast<size_t>(std::max(2, initialSlotCount))),
+      distances_(static_cast<size_t>(std::max(2, initialSlotCount)), kEmpty),
+      numElements_(0),
+      maxLoadFactor_(std::min(maxLoadFactor, 0.95f)) {
+}
+
+template <typename TracePolicy>
+void BasicRobinHoodHashMap<TracePolicy>::clearSteps() {
+    trace_.clear();
+}
+
+template <typename TracePolicy>
+const HashStepTrace &BasicRobinHoodHashMap<TracePolicy>::lastSteps() const {
+    return trace_.steps();
+}
+
+template <typename TracePolicy>
+int BasicRobinHoodHashMap<TracePolicy>::size() const {
+    return numElements_;
+}
+
+template <typename TracePolicy>
+int BasicRobinHoodHashMap<TracePolicy>::bucketCount() const {
+    return static_cast<int>(distances_.size());
+}
+
+template <typename TracePolicy>
+float BasicRobinHoodHashMap<TracePolicy>::loadFactor() const {
+    if (distances_.empty()) return 0.0f;
+    return static_cast<float>(numElements_) / static_cast<float>(distances_.size());
+}
+
+template <typename TracePolicy>
+void BasicRobinHoodHashMap<TracePolicy>::maybeGrow() {
+    const float projected = (static_cast<float>(numElements_) + 1.0f)
+        / static_cast<float>(distances_.empty() ? 1 : distances_.size());
+    if (projected > maxLoadFactor_) {
+        const int newCount = std::max(2, bucketCount() * 2);
+        trace_.add(HashStepOp::GrowRehash, [&](HashStep &s) {
+            s.bucket = newCount;
+            s.loadFactor = loadFactor();
+            s.loadFactor2 = maxLoadFactor_;
+        });
+        rehash(newCount);
+    }
+}
+
+template <typename TracePolicy>
+void BasicRobinHoodHashMap<TracePolicy>::placeNew(Entry entry, int slot, int distance) {
+    // Walk forward from `slot`, swapping the carried entry with any resident
+    // that sits closer to its home slot ("take from the rich").
+    for (;;) {
+        const size_t i = static_cast<size_t>(slot);
+        if (distances_[i] == kEmpty) {
+            entries_[i] = std::move(entry);
+            distances_[i] = distance;
+            trace_.add(HashStepOp::PlaceInSlot, [&](HashStep &s) { s.bucket = slot; s.count = distance; });
+            return;
+        }
+        if (distances_[i] < distance) {
+            trace_.add(HashStepOp::Displace, [&](HashStep &s) {
+                s.keyRef = trace_.ref(entries_[i].key);
+                s.bucket = slot;
+                s.count = distances_[i];
+            });
+            std::swap(entry, entries_[i]);
+            std::swap(distance, distances_[i]);
+            trace_.add(HashStepOp::PlaceInSlot, [&](HashStep &s) { s.bucket = slot; s.count = distances_[i]; });
+        }
+        slot = nextSlot(slot);
+        ++distance;
+    }
+}
+
+template <typename TracePolicy>
+bool BasicRobinHoodHashMap<TracePolicy>::emplaceOrAssign(const QString &key, const QString &value, bool assignIfExists) {
+    const int slotCount = bucketCount();
+    const size_t hash = static_cast<size_t>(qHash(key));
+    const int home = homeSlot(hash, slotCount);
+
+    const int keyRef = trace_.ref(key);
+    trace_.add(HashStepOp::ComputeHash, [&](HashStep &s) { s.hash = hash; s.keyRef = keyRef; });
+    trace_.add(HashStepOp::ComputeIndex, [&](HashStep &s) { s.count = slotCount; s.bucket = home; });
+
+    int slot = home;
+    for (int distance = 0;; ++distance) {
+        const size_t i = static_cast<size_t>(slot);
+        trace_.add(HashStepOp::ProbeSlot, [&](HashStep &s) { s.bucket = slot; s.count = distance; });
+        if (distances_[i] == kEmpty || distances_[i] < distance) {
+            // Either a free slot or a richer resident: the key cannot be
+            // further along this run, so it is new.
+            if (distances_[i] == kEmpty) {
+                trace_.add(HashStepOp::EmptySlot, [&](HashStep &s) { s.bucket = slot; });
+            }
+            placeNew(Entry{key, value}, slot, distance);
+            ++numElements_;
+            trace_.add(HashStepOp::NewSize, [&](HashStep &s) {
+                s.count = numElements_;
+                s.loadFactor = loadFactor();
+            });
+            return true;
+        }
+        if (distances_[i] == distance) {
+            // Only an entry with the same probe distance can share our home slot.
+            Entry &entry = entries_[i];
+            const bool matched = entry.key == key;
+            trace_.add(HashStepOp::CompareKeys, [&](HashStep &s) {
+                s.keyRef = trace_.ref(entry.key);
+                s.otherRef = keyRef;
+                s.matched = matched;
+            });
+            if (matched) {
+                if (assignIfExists) {
+                    trace_.add(HashStepOp::UpdateValue, [&](HashStep &s) {
+                        s.keyRef = trace_.ref(entry.value);
+                        s.otherRef = trace_.ref(value);
+                    });
+                    entry.value = value;
+                } else {
+                    trace_.add(HashStepOp::DuplicateKey);
+                }
+                return false; // not a new insertion
+            }
+        }
+        slot = nextSlot(slot);
+    }
+}
+
+template <typename TracePolicy>
+int BasicRobinHoodHashMap<TracePolicy>::findSlot(const QString &key) {
+    const int slotCount = bucketCount();
+    const size_t hash = static_cast<size_t>(qHash(key));
+    const int home = homeSlot(hash, slotCount);
+
+    const int keyRef = trace_.ref(key);
+    trace_.add(HashStepOp::ComputeHash, [&](HashStep &s) { s.hash = hash; s.keyRef = keyRef; });
+    trace_.add(HashStepOp::ComputeIndex, [&](HashStep &s) { s.count = slotCount; s.bucket = home; });
+
+    int slot = home;
+    for (int distance = 0; distance < slotCount; ++distance) {
+        const size_t i = static_cast<size_t>(slot);
+        trace_.add(HashStepOp::ProbeSlot, [&](HashStep &s) { s.bucket = slot; s.count = distance; });
+        if (distances_[i] == kEmpty) {
+            trace_.add(HashStepOp::EmptySlot, [&](HashStep &s) { s.bucket = slot; });
+            return -1;
+        }
+        if (distances_[i] < distance) {
+            trace_.add(HashStepOp::ProbeStop, [&](HashStep &s) { s.bucket = slot; s.count = distance; });
+            return -1;
+        }
+        if (distances_[i] == distance) {
+            const bool matched = entries_[i].key == key;
+            trace_.add(HashStepOp::CompareKeys, [&](HashStep &s) {
+                s.keyRef = trace_.ref(entries_[i].key);
+                s.otherRef = keyRef;
+                s.matched = matched;
+            });
+            if (matched) return slot;
+        }
+        slot = nextSlot(slot);
+    }
+    return -1;
+}
+
+template <typename TracePolicy>
+bool BasicRobinHoodHashMap<TracePolicy>::insert(const QString &key, const QString &value) {
+    clearSteps();
+    maybeGrow();
+    return emplaceOrAssign(key, value, /*assignIfExists=*/false);
+}
+
+template <typename TracePolicy>
+void BasicRobinHoodHashMap<TracePolicy>::put(const QString &key, const QString &value) {
+    clearSteps();
+    maybeGrow();
+    (void)emplaceOrAssign(key, value, /*assignIfExists=*/true);
+}
+
+template <typename TracePolicy>
+std::optional<QString> BasicRobinHoodHashMap<TracePolicy>::get(const QString &key) {
+    clearSteps();
+    if (numElements_ == 0) {
+        trace_.add(HashStepOp::TableEmpty);
+        return std::nullopt;
+    }
+
+    const int slot = findSlot(key);
+    if (slot < 0) {
+        trace_.add(HashStepOp::NotFound);
+        return std::nullopt;
+    }
+    const QString &value = entries_[static_cast<size_t>(slot)].value;
+    trace_.add(HashStepOp::Found, [&](HashStep &s) { s.keyRef = trace_.ref(value); });
+    return value;
+}
+
+template <typename TracePolicy>
+bool BasicRobinHoodHashMap<TracePolicy>::erase(const QString &key) {
+    clearSteps();
+    if (numElements_ == 0) {
+        trace_.add(HashStepOp::EraseEmpty);
+        return false;
+    }
+
+    int slot = findSlot(key);
+    if (slot < 0) {
+        trace_.add(HashStepOp::EraseNotFound);
+        return false;
+    }
+
+    // Backward-shift deletion: pull the rest of the run one slot closer to
+    // home until an empty slot or an entry already at home is reached.
+    int next = nextSlot(slot);
+    while (distances_[static_cast<size_t>(next)] > 0) {
+        trace_.add(HashStepOp::ShiftBack, [&](HashStep &s) { s.bucket = next; s.count = slot; });
+        entries_[static_cast<size_t>(slot)] = std::move(entries_[static_cast<size_t>(next)]);
+        distances_[static_cast<size_t>(slot)] = distances_[static_cast<size_t>(next)] - 1;
+        slot = next;
+        next = nextSlot(next);
+    }
+    entries_[static_cast<size_t>(slot)] = Entry{};
+    distances_[static_cast<size_t>(slot)] = kEmpty;
+    --numElements_;
+    trace_.add(HashStepOp::Erased, [&](HashStep &s) {
+        s.count = numElements_;
+        s.loadFactor = loadFactor();
+    });
+    return true;
+}
+
+template <typename TracePolicy>
+bool BasicRobinHoodHashMap<TracePolicy>::contains(const QString &key) {
+    return get(key).has_value();
+}
+
+template <typename TracePolicy>
+void BasicRobinHoodHashMap<TracePolicy>::clear() {
+    clearSteps();
+    std::fill(entries_.begin(), entries_.end(), Entry{});
+    std::fill(distances_.begin(), distances_.end(), kEmpty);
+    numElements_ = 0;
+    trace_.add(HashStepOp::Cleared);
+}
+
+template <typename TracePolicy>
+void BasicRobinHoodHashMap<TracePolicy>::rehash(int newSlotCount) {
+    // Open addressing needs at least one free slot to terminate probes.
+    newSlotCount = std::max({2, newSlotCount, numElements_ + 1});
+    trace_.add(HashStepOp::Rehashing, [&](HashStep &s) {
+        s.count = bucketCount();
+        s.bucket = newSlotCount;
+    });
+
+    std::vector<Entry> oldEntries;
+    std::vector<int> oldDistances;
+    oldEntries.swap(entries_);
+    oldDistances.swap(distances_);
+    entries_.resize(static_cast<size_t>(newSlotCount));
+    distances_.assign(static_cast<size_t>(newSlotCount), kEmpty);
+
+    for (size_t i = 0; i < oldEntries.size(); ++i) {
+        if (oldDistances[i] == kEmpty) continue;
+        Entry &entry = oldEntries[i];
+        const int home = homeSlot(static_cast<size_t>(qHash(entry.key)), newSlotCount);
+        trace_.add(HashStepOp::MoveNode, [&](HashStep &s) {
+            s.keyRef = trace_.ref(entry.key);
+            s.otherRef = trace_.ref(entry.value);
+            s.bucket = home;
+        });
+        placeNew(std::move(entry), home, 0);
+    }
+}
+
+template <typename TracePolicy>
+void BasicRobinHoodHashMap<TracePolicy>::reserve(int expectedElements) {
+    if (expectedElements <= 0) return;
+    const int requiredSlots = static_cast<int>(expectedElements / maxLoadFactor_) + 1;
+    if (requiredSlots > bucketCount()) {
+        trace_.add(HashStepOp::ReserveRehash, [&](HashStep &s) {
+            s.count = expectedElements;
+            s.bucket = requiredSlots;
+        });
+        rehash(requiredSlots);
+    }
+}
+
+template <typename TracePolicy>
+QVector<int> BasicRobinHoodHashMap<TracePolicy>::bucketSizes() const {
+    QVector<int> sizes;
+    sizes.reserve(static_cast<int>(distances_.size()));
+    for (int distance : distances_) {
+        sizes.push_back(distance == kEmpty ? 0 : 1);
+    }
+    return sizes;
+}
+
+template <typename TracePolicy>
+QVector<int> BasicRobinHoodHashMap<TracePolicy>::probeLengths() const {
+    QVector<int> lengths;
+    lengths.reserve(static_cast<int>(distances_.size()));
+    for (int distance : distances_) {
+        lengths.push_back(distance);
+    }
+    return lengths;
+}
+
+template class BasicRobinHoodHashMap<StepTrace>;
+template class BasicRobinHoodHashMap<NoTrace>;
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <QString>
+#include <QVector>
+#include <QHashFunctions>
+#include "hashstep.h"
+#include <optional>
+#include <vector>
+
+// Open-addressing HashMap using Robin Hood linear probing with backward-shift
+// deletion. Same API and step trace as BasicHashMap; entries live in one
+// contiguous slot array and probe distances in a parallel metadata array.
+template <typename TracePolicy>
+class BasicRobinHoodHashMap {
+public:
+    explicit BasicRobinHoodHashMap(int initialSlotCount = 16, float maxLoadFactor = 0.85f);
+
+    // Inserts a new key/value. Returns true if a new element was inserted,
+    // false if the key already exists (value is left unchanged).
+    bool insert(const QString &key, const QString &value);
+
+    // Upsert variant: always assigns value (inserts if missing, updates if present).
+    void put(const QString &key, const QString &value);
+
+    std::optional<QString> get(const QString &key);
+
+    // Erases a key if present, shifting the following run back by one slot.
+    bool erase(const QString &key);
+
+    bool contains(const QString &key);
+
+    void clear();
+
+    int size() const;
+    int bucketCount() const;
+    float loadFactor() const;
+
+    void rehash(int newSlotCount);
+    void reserve(int expectedElements);
+
+    // Visualization helpers. Always empty when tracing is disabled.
+    const HashStepTrace &lastSteps() const;
+    void clearSteps();
+    // 1 for an occupied slot, 0 for an empty one.
+    QVector<int> bucketSizes() const;
+    // Probe distance from the home slot per slot, -1 for an empty one.
+    QVector<int> probeLengths() const;
+
+private:
+    struct Entry {
+        QString key;
+        QString value;
+    };
+
+    static constexpr int kEmpty = -1;
+
+    std::vector<Entry> entries_;
+    std::vector<int> distances_; // kEmpty or distance from the home slot
+    int numElements_ = 0;
+    float maxLoadFactor_ = 0.85f;
+    StepRecorder<TracePolicy> trace_;
+
+    inline int homeSlot(size_t hash, int slotCount) const {
+        return static_cast<int>(hash % static_cast<size_t>(slotCount));
+    }
+
+    inline int nextSlot(int slot) const {
+        return slot + 1 == bucketCount() ? 0 : slot + 1;
+    }
+
+    int findSlot(const QString &key);
+    bool emplaceOrAssign(const QString &key, const QString &value, bool assignIfExists);
+    void placeNew(Entry entry, int slot, int distance);
+    void maybeGrow();
+};
+
+// Tracing build used by the visualizer.
+using RobinHoodHashMap = BasicRobinHoodHashMap<StepTrace>;
+
+// Trace-free build for headless workloads.
+using FastRobinHoodHashMap = BasicRobinHoodHashMap<NoTrace>;
+
+extern template class BasicRobinHoodHashMap<StepTrace>;
+extern template class BasicRobinHoodHashMap<NoTrace>;
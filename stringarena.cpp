@@ -0,0 +1,97 @@
+#include "stringarena.h"
+
+#include <QLatin1StringView>
+#include <QStringEncoder>
+#include <QUtf8StringView>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+constexpr quint32 kUtf8Flag = 1;
+
+quint32 readHeader(const char *stored) {
+    quint32 header = 0;
+    std::memcpy(&header, stored, sizeof(header));
+    return header;
+}
+
+void writeHeader(char *stored, qsizetype length, bool utf8) {
+    const quint32 header = (static_cast<quint32>(length) << 1) | (utf8 ? kUtf8Flag : 0);
+    std::memcpy(stored, &header, sizeof(header));
+}
+
+} // namespace
+
+StringArena::StringArena(qsizetype chunkSize)
+    : chunkSize_(std::max<qsizetype>(chunkSize, 256)) {
+}
+
+char *StringArena::allocate(qsizetype size) {
+    if (end_ - cursor_ < size) {
+        // The rest of the current chunk is abandoned; oversized entries get
+        // a chunk of their own.
+        const qsizetype chunk = std::max(chunkSize_, size);
+        chunks_.emplace_back(new char[static_cast<size_t>(chunk)]);
+        cursor_ = chunks_.back().get();
+        end_ = cursor_ + chunk;
+        allocated_ += chunk;
+    }
+    char *result = cursor_;
+    cursor_ += size;
+    used_ += size;
+    return result;
+}
+
+const char *StringArena::store(QStringView text) {
+    const qsizetype length = text.size();
+    const bool latin1 = std::all_of(text.begin(), text.end(), [](QChar c) { return c.unicode() < 0x100; });
+    if (latin1) {
+        char *stored = allocate(kHeaderSize + length);
+        writeHeader(stored, length, /*utf8=*/false);
+        char *out = stored + kHeaderSize;
+        for (qsizetype i = 0; i < length; ++i) {
+            out[i] = static_cast<char>(text[i].unicode());
+        }
+        return stored;
+    }
+
+    // Encode straight into the arena at worst-case size, then hand the
+    // unused tail back; it is always the most recent allocation.
+    QStringEncoder encoder(QStringEncoder::Utf8);
+    const qsizetype worstCase = encoder.requiredSpace(length);
+    char *stored = allocate(kHeaderSize + worstCase);
+    const char *end = encoder.appendToBuffer(stored + kHeaderSize, text);
+    const qsizetype encoded = end - (stored + kHeaderSize);
+    writeHeader(stored, encoded, /*utf8=*/true);
+    cursor_ -= worstCase - encoded;
+    used_ -= worstCase - encoded;
+    return stored;
+}
+
+const char *StringArena::storeCopy(const char *stored) {
+    const qsizetype size = storedSize(stored);
+    char *copy = allocate(size);
+    std::memcpy(copy, stored, static_cast<size_t>(size));
+    return copy;
+}
+
+QAnyStringView StringArena::view(const char *stored) {
+    const quint32 header = readHeader(stored);
+    const qsizetype length = static_cast<qsizetype>(header >> 1);
+    const char *payload = stored + kHeaderSize;
+    if (header & kUtf8Flag) {
+        return QUtf8StringView(payload, length);
+    }
+    return QLatin1StringView(payload, length);
+}
+
+qsizetype StringArena::storedSize(const char *stored) {
+    return kHeaderSize + static_cast<qsizetype>(readHeader(stored) >> 1);
+}
+
+void StringArena::clear() {
+    chunks_.clear();
+    cursor_ = end_ = nullptr;
+    used_ = allocated_ = 0;
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <QAnyStringView>
+#include <QStringView>
+#include <QtGlobal>
+#include <memory>
+#include <vector>
+
+// Bump allocator for immutable strings. Each entry is a 4-byte header
+// (length << 1 | encoding) followed by the payload, stored as Latin-1 when
+// every code unit fits and as UTF-8 otherwise. Entries are addressed by the
+// pointer store() returns and read back as a QAnyStringView, so short ASCII
+// strings cost length + 4 bytes instead of a QString header plus a UTF-16
+// heap block. Unpaired surrogates do not survive the UTF-8 round trip.
+//
+// Nothing is freed individually: owners track dead bytes and rebuild into a
+// fresh arena (see ArenaHashMap::compact()).
+class StringArena {
+public:
+    explicit StringArena(qsizetype chunkSize = 64 * 1024);
+
+    StringArena(StringArena &&) noexcept = default;
+    StringArena &operator=(StringArena &&) noexcept = default;
+    Q_DISABLE_COPY(StringArena)
+
+    const char *store(QStringView text);
+
+    // Copies an entry from another arena byte for byte, without re-encoding.
+    const char *storeCopy(const char *stored);
+
+    static QAnyStringView view(const char *stored);
+    static qsizetype storedSize(const char *stored); // header + payload
+
+    void clear(); // releases every chunk
+
+    qsizetype bytesUsed() const { return used_; }
+    qsizetype bytesAllocated() const { return allocated_; }
+
+private:
+    static constexpr qsizetype kHeaderSize = 4;
+
+    char *allocate(qsizetype size);
+
+    std::vector<std::unique_ptr<char[]>> chunks_;
+    char *cursor_ = nullptr;
+    char *end_ = nullptr;
+    qsizetype chunkSize_ = 0;
+    qsizetype used_ = 0;
+    qsizetype allocated_ = 0;
+};
@@ -0,0 +1,358 @@
+#include "swisshashmap.h"
+
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SWISS_USE_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+// Bit i of the result is set when control byte i of the group satisfies the
+// predicate. Groups are always 16 bytes and 16-byte aligned within ctrl_.
+#ifdef SWISS_USE_SSE2
+inline quint32 matchByte(const qint8 *group, qint8 value) {
+    const __m128i ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i *>(group));
+    return static_cast<quint32>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(value), ctrl)));
+}
+
+inline quint32 matchEmptyOrDeleted(const qint8 *group) {
+    // Full slots are 0..127; both markers are below -1.
+    const __m128i ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i *>(group));
+    return static_cast<quint32>(_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(-1), ctrl)));
+}
+#else
+inline quint32 matchByte(const qint8 *group, qint8 value) {
+    quint32 mask = 0;
+    for (int i = 0; i < 16; ++i) {
+        mask |= static_cast<quint32>(group[i] == value) << i;
+    }
+    return mask;
+}
+
+inline quint32 matchEmptyOrDeleted(const qint8 *group) {
+    quint32 mask = 0;
+    for (int i = 0; i < 16; ++i) {
+        mask |= static_cast<quint32>(group[i] < -1) << i;
+    }
+    return mask;
+}
+#endif
+
+inline int lowestBit(quint32 mask) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctz(mask);
+#else
+    int bit = 0;
+    while (!(mask & 1u)) {
+        mask >>= 1;
+        ++bit;
+    }
+    return bit;
+#endif
+}
+
+// Low 7 bits select candidates within a group; the rest pick the group.
+inline qint8 h2(size_t hash) { return static_cast<qint8>(hash & 0x7f); }
+inline size_t h1(size_t hash) { return hash >> 7; }
+
+int roundUpGroups(int slotCount) {
+    const int wanted = std::max(1, (slotCount + 15) / 16);
+    int groups = 1;
+    while (groups < wanted) groups *= 2;
+    return groups;
+}
+
+} // namespace
+
+template <typename TracePolicy>
+BasicSwissHashMap<TracePolicy>::BasicSwissHashMap(int initialSlotCount, float maxLoadFactor)
+    : ctrl_(static_cast<size_t>(roundUpGroups(initialSlotCount) * kGroupSize), kEmpty),
+      entries_(ctrl_.size()),
+      numElements_(0),
+      numDeleted_(0),
+      maxLoadFactor_(std::min(maxLoadFactor, 0.875f)) {
+}
+
+template <typename TracePolicy>
+void BasicSwissHashMap<TracePolicy>::clearSteps() {
+    trace_.clear();
+}
+
+template <typename TracePolicy>
+const HashStepTrace &BasicSwissHashMap<TracePolicy>::lastSteps() const {
+    return trace_.steps();
+}
+
+template <typename TracePolicy>
+int BasicSwissHashMap<TracePolicy>::size() const {
+    return numElements_;
+}
+
+template <typename TracePolicy>
+int BasicSwissHashMap<TracePolicy>::bucketCount() const {
+    return static_cast<int>(ctrl_.size());
+}
+
+template <typename TracePolicy>
+float BasicSwissHashMap<TracePolicy>::loadFactor() const {
+    if (ctrl_.empty()) return 0.0f;
+    return static_cast<float>(numElements_) / static_cast<float>(ctrl_.size());
+}
+
+template <typename TracePolicy>
+void BasicSwissHashMap<TracePolicy>::maybeGrow() {
+    // Tombstones occupy probe sequences too, so they count towards the load.
+    const float projected = (static_cast<float>(numElements_ + numDeleted_) + 1.0f)
+        / static_cast<float>(ctrl_.size());
+    if (projected > maxLoadFactor_) {
+        // Mostly tombstones: rehash in place to purge them instead of growing.
+        const bool purgeOnly = numDeleted_ > numElements_;
+        const int newCount = purgeOnly ? bucketCount() : bucketCount() * 2;
+        trace_.add(HashStepOp::GrowRehash, [&](HashStep &s) {
+            s.bucket = newCount;
+            s.loadFactor = projected;
+            s.loadFactor2 = maxLoadFactor_;
+        });
+        rehash(newCount);
+    }
+}
+
+template <typename TracePolicy>
+int BasicSwissHashMap<TracePolicy>::findSlot(const QString &key, size_t hash, int keyRef) {
+    const int groups = groupCount();
+    const qint8 tag = h2(hash);
+    int group = static_cast<int>(h1(hash) & static_cast<size_t>(groups - 1));
+
+    // Triangular probing over a power-of-two group count visits every group.
+    for (int step = 1; step <= groups; ++step) {
+        const qint8 *ctrl = ctrl_.data() + group * kGroupSize;
+        quint32 candidates = matchByte(ctrl, tag);
+        trace_.add(HashStepOp::ProbeGroup, [&](HashStep &s) {
+            s.bucket = group;
+            s.hash = static_cast<quint64>(tag);
+            s.count = static_cast<int>(candidates);
+        });
+        while (candidates) {
+            const int slot = group * kGroupSize + lowestBit(candidates);
+            const Entry &entry = entries_[static_cast<size_t>(slot)];
+            const bool matched = entry.key == key;
+            trace_.add(HashStepOp::CompareKeys, [&](HashStep &s) {
+                s.keyRef = trace_.ref(entry.key);
+                s.otherRef = keyRef;
+                s.matched = matched;
+            });
+            if (matched) return slot;
+            candidates &= candidates - 1;
+        }
+        if (matchByte(ctrl, kEmpty)) {
+            // An empty slot means the key was never pushed past this group.
+            trace_.add(HashStepOp::GroupHasEmpty, [&](HashStep &s) { s.bucket = group; });
+            return -1;
+        }
+        group = (group + step) & (groups - 1);
+    }
+    return -1;
+}
+
+template <typename TracePolicy>
+int BasicSwissHashMap<TracePolicy>::findInsertSlot(size_t hash) const {
+    const int groups = groupCount();
+    int group = static_cast<int>(h1(hash) & static_cast<size_t>(groups - 1));
+    for (int step = 1;; ++step) {
+        const quint32 free = matchEmptyOrDeleted(ctrl_.data() + group * kGroupSize);
+        if (free) return group * kGroupSize + lowestBit(free);
+        group = (group + step) & (groups - 1);
+    }
+}
+
+template <typename TracePolicy>
+bool BasicSwissHashMap<TracePolicy>::emplaceOrAssign(const QString &key, const QString &value, bool assignIfExists) {
+    const size_t hash = static_cast<size_t>(qHash(key));
+    const int keyRef = trace_.ref(key);
+    trace_.add(HashStepOp::ComputeHash, [&](HashStep &s) { s.hash = hash; s.keyRef = keyRef; });
+
+    const int existing = findSlot(key, hash, keyRef);
+    if (existing >= 0) {
+        Entry &entry = entries_[static_cast<size_t>(existing)];
+        if (assignIfExists) {
+            trace_.add(HashStepOp::UpdateValue, [&](HashStep &s) {
+                s.keyRef = trace_.ref(entry.value);
+                s.otherRef = trace_.ref(value);
+            });
+            entry.value = value;
+        } else {
+            trace_.add(HashStepOp::DuplicateKey);
+        }
+        return false; // not a new insertion
+    }
+
+    const int slot = findInsertSlot(hash);
+    if (ctrl_[static_cast<size_t>(slot)] == kDeleted) --numDeleted_;
+    ctrl_[static_cast<size_t>(slot)] = h2(hash);
+    entries_[static_cast<size_t>(slot)] = Entry{key, value};
+    ++numElements_;
+    trace_.add(HashStepOp::ClaimSlot, [&](HashStep &s) {
+        s.bucket = slot;
+        s.hash = static_cast<quint64>(h2(hash));
+    });
+    trace_.add(HashStepOp::NewSize, [&](HashStep &s) {
+        s.count = numElements_;
+        s.loadFactor = loadFactor();
+    });
+    return true;
+}
+
+template <typename TracePolicy>
+bool BasicSwissHashMap<TracePolicy>::insert(const QString &key, const QString &value) {
+    clearSteps();
+    maybeGrow();
+    return emplaceOrAssign(key, value, /*assignIfExists=*/false);
+}
+
+template <typename TracePolicy>
+void BasicSwissHashMap<TracePolicy>::put(const QString &key, const QString &value) {
+    clearSteps();
+    maybeGrow();
+    (void)emplaceOrAssign(key, value, /*assignIfExists=*/true);
+}
+
+template <typename TracePolicy>
+std::optional<QString> BasicSwissHashMap<TracePolicy>::get(const QString &key) {
+    clearSteps();
+    if (numElements_ == 0) {
+        trace_.add(HashStepOp::TableEmpty);
+        return std::nullopt;
+    }
+
+    const size_t hash = static_cast<size_t>(qHash(key));
+    const int keyRef = trace_.ref(key);
+    trace_.add(HashStepOp::ComputeHash, [&](HashStep &s) { s.hash = hash; s.keyRef = keyRef; });
+
+    const int slot = findSlot(key, hash, keyRef);
+    if (slot < 0) {
+        trace_.add(HashStepOp::NotFound);
+        return std::nullopt;
+    }
+    const QString &value = entries_[static_cast<size_t>(slot)].value;
+    trace_.add(HashStepOp::Found, [&](HashStep &s) { s.keyRef = trace_.ref(value); });
+    return value;
+}
+
+template <typename TracePolicy>
+bool BasicSwissHashMap<TracePolicy>::erase(const QString &key) {
+    clearSteps();
+    if (numElements_ == 0) {
+        trace_.add(HashStepOp::EraseEmpty);
+        return false;
+    }
+
+    const size_t hash = static_cast<size_t>(qHash(key));
+    const int keyRef = trace_.ref(key);
+    trace_.add(HashStepOp::ComputeHash, [&](HashStep &s) { s.hash = hash; s.keyRef = keyRef; });
+
+    const int slot = findSlot(key, hash, keyRef);
+    if (slot < 0) {
+        trace_.add(HashStepOp::EraseNotFound);
+        return false;
+    }
+
+    // If the group still has an empty slot no probe ever continued past it,
+    // so the slot can become empty again; otherwise leave a tombstone.
+    const int group = slot / kGroupSize;
+    const bool groupHasEmpty = matchByte(ctrl_.data() + group * kGroupSize, kEmpty) != 0;
+    ctrl_[static_cast<size_t>(slot)] = groupHasEmpty ? kEmpty : kDeleted;
+    if (!groupHasEmpty) ++numDeleted_;
+    entries_[static_cast<size_t>(slot)] = Entry{};
+    --numElements_;
+    trace_.add(HashStepOp::Erased, [&](HashStep &s) {
+        s.count = numElements_;
+        s.loadFactor = loadFactor();
+    });
+    return true;
+}
+
+template <typename TracePolicy>
+bool BasicSwissHashMap<TracePolicy>::contains(const QString &key) {
+    return get(key).has_value();
+}
+
+template <typename TracePolicy>
+void BasicSwissHashMap<TracePolicy>::clear() {
+    clearSteps();
+    std::fill(ctrl_.begin(), ctrl_.end(), kEmpty);
+    std::fill(entries_.begin(), entries_.end(), Entry{});
+    numElements_ = 0;
+    numDeleted_ = 0;
+    trace_.add(HashStepOp::Cleared);
+}
+
+template <typename TracePolicy>
+void BasicSwissHashMap<TracePolicy>::rehash(int newSlotCount) {
+    const int minSlots = static_cast<int>(numElements_ / maxLoadFactor_) + 1;
+    const int groups = roundUpGroups(std::max(newSlotCount, minSlots));
+    const int slotCount = groups * kGroupSize;
+    trace_.add(HashStepOp::Rehashing, [&](HashStep &s) {
+        s.count = bucketCount();
+        s.bucket = slotCount;
+    });
+
+    std::vector<qint8> oldCtrl;
+    std::vector<Entry> oldEntries;
+    oldCtrl.swap(ctrl_);
+    oldEntries.swap(entries_);
+    ctrl_.assign(static_cast<size_t>(slotCount), kEmpty);
+    entries_.resize(static_cast<size_t>(slotCount));
+    numDeleted_ = 0;
+
+    for (size_t i = 0; i < oldCtrl.size(); ++i) {
+        if (oldCtrl[i] < 0) continue;
+        Entry &entry = oldEntries[i];
+        const size_t hash = static_cast<size_t>(qHash(entry.key));
+        const int slot = findInsertSlot(hash);
+        trace_.add(HashStepOp::MoveNode, [&](HashStep &s) {
+            s.keyRef = trace_.ref(entry.key);
+            s.otherRef = trace_.ref(entry.value);
+            s.bucket = slot;
+        });
+        ctrl_[static_cast<size_t>(slot)] = h2(hash);
+        entries_[static_cast<size_t>(slot)] = std::move(entry);
+    }
+}
+
+template <typename TracePolicy>
+void BasicSwissHashMap<TracePolicy>::reserve(int expectedElements) {
+    if (expectedElements <= 0) return;
+    const int requiredSlots = static_cast<int>(expectedElements / maxLoadFactor_) + 1;
+    if (requiredSlots > bucketCount()) {
+        trace_.add(HashStepOp::ReserveRehash, [&](HashStep &s) {
+            s.count = expectedElements;
+            s.bucket = requiredSlots;
+        });
+        rehash(requiredSlots);
+    }
+}
+
+template <typename TracePolicy>
+QVector<int> BasicSwissHashMap<TracePolicy>::bucketSizes() const {
+    QVector<int> sizes;
+    sizes.reserve(static_cast<int>(ctrl_.size()));
+    for (qint8 c : ctrl_) {
+        sizes.push_back(c >= 0 ? 1 : 0);
+    }
+    return sizes;
+}
+
+template <typename TracePolicy>
+QVector<int> BasicSwissHashMap<TracePolicy>::controlBytes() const {
+    QVector<int> bytes;
+    bytes.reserve(static_cast<int>(ctrl_.size()));
+    for (qint8 c : ctrl_) {
+        bytes.push_back(c);
+    }
+    return bytes;
+}
+
+template class BasicSwissHashMap<StepTrace>;
+template class BasicSwissHashMap<NoTrace>;
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <QString>
+#include <QVector>
+#include <QHashFunctions>
+#include "hashstep.h"
+#include <optional>
+#include <vector>
+
+// Open-addressing HashMap on the Swiss-table design. Every slot has a control
+// byte holding 7 bits of its hash (or an empty/deleted marker); probes scan
+// 16 control bytes per group at once (SSE2 where available, scalar
+// otherwise) and only compare keys of slots whose 7 bits match. Same API and
+// step trace as BasicHashMap; the trace reports group-level matches.
+template <typename TracePolicy>
+class BasicSwissHashMap {
+public:
+    static constexpr int kGroupSize = 16;
+
+    explicit BasicSwissHashMap(int initialSlotCount = 16, float maxLoadFactor = 0.875f);
+
+    // Inserts a new key/value. Returns true if a new element was inserted,
+    // false if the key already exists (value is left unchanged).
+    bool insert(const QString &key, const QString &value);
+
+    // Upsert variant: always assigns value (inserts if missing, updates if present).
+    void put(const QString &key, const QString &value);
+
+    std::optional<QString> get(const QString &key);
+
+    bool erase(const QString &key);
+
+    bool contains(const QString &key);
+
+    void clear();
+
+    int size() const;
+    int bucketCount() const;
+    float loadFactor() const;
+
+    void rehash(int newSlotCount);
+    void reserve(int expectedElements);
+
+    // Visualization helpers. Always empty when tracing is disabled.
+    const HashStepTrace &lastSteps() const;
+    void clearSteps();
+    // 1 for a full slot, 0 for an empty or deleted one.
+    QVector<int> bucketSizes() const;
+    // Raw control byte per slot: 0..127 = stored hash bits, kEmpty, kDeleted.
+    QVector<int> controlBytes() const;
+
+    static constexpr qint8 kEmpty = -128;
+    static constexpr qint8 kDeleted = -2;
+
+private:
+    struct Entry {
+        QString key;
+        QString value;
+    };
+
+    std::vector<qint8> ctrl_;
+    std::vector<Entry> entries_;
+    int numElements_ = 0;
+    int numDeleted_ = 0;
+    float maxLoadFactor_ = 0.875f;
+    StepRecorder<TracePolicy> trace_;
+
+    inline int groupCount() const {
+        return static_cast<int>(ctrl_.size()) / kGroupSize;
+    }
+
+    int findSlot(const QString &key, size_t hash, int keyRef);
+    int findInsertSlot(size_t hash) const;
+    bool emplaceOrAssign(const QString &key, const QString &value, bool assignIfExists);
+    void maybeGrow();
+};
+
+// Tracing build used by the visualizer.
+using SwissHashMap = BasicSwissHashMap<StepTrace>;
+
+// Trace-free build for headless workloads.
+using FastSwissHashMap = BasicSwissHashMap<NoTrace>;
+
+extern template class BasicSwissHashMap<StepTrace>;
+extern template class BasicSwissHashMap<NoTrace>;
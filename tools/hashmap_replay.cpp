@@ -0,0 +1,194 @@
+#include <QCommandLineOption>
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QStringList>
+#include <QTextStream>
+#include "concurrenthashmap.h"
+#include "hashmap.h"
+#include "oplog.h"
+#include "readoptimizedhashmap.h"
+#include "robinhoodhashmap.h"
+#include "swisshashmap.h"
+#include <algorithm>
+#include <functional>
+#include <memory>
+
+// Headless replayer for operation logs recorded by the HashMap
+// visualizer (see oplog.h). Every repetition replays the whole log against
+// a freshly built map, and the report covers all repetitions together:
+//
+//   AdvDS_replay session.oplog --engine chaining --index pow2 --bloom --repeat 10
+//
+// Maps start with the bucket count stored in the log, or 8 (the
+// visualizer's table size) for logs that predate it; --buckets overrides
+// both.
+
+namespace {
+
+struct ReplayConfig {
+    int buckets = 8;
+    int repeat = 1;
+    int sampleEvery = 16;
+    bool incremental = false;
+    bool bloom = false;
+};
+
+// Configuration knobs that only the chained map has.
+template <typename T, typename I, typename H>
+void configure(BasicHashMap<T, I, H> &map, const ReplayConfig &config) {
+    map.setIncrementalRehash(config.incremental);
+    map.setBloomFilter(config.bloom);
+}
+template <typename Map>
+void configure(Map &, const ReplayConfig &) {}
+
+// Builds a map per repetition through makeMap and replays into it.
+template <typename Map>
+qint64 replayRepeated(const std::function<std::unique_ptr<Map>()> &makeMap, const std::vector<LoggedOperation> &operations,
+                      const ReplayConfig &config, HashMetricsRecorder &recorder) {
+    qint64 nanos = 0;
+    for (int run = 0; run < config.repeat; ++run) {
+        std::unique_ptr<Map> map = makeMap();
+        configure(*map, config);
+        nanos += replayOperations(*map, operations, &recorder);
+    }
+    return nanos;
+}
+
+// For maps whose constructor takes the initial bucket count.
+template <typename Map>
+qint64 replaySized(const std::vector<LoggedOperation> &operations, const ReplayConfig &config, HashMetricsRecorder &recorder) {
+    return replayRepeated<Map>([&] { return std::make_unique<Map>(config.buckets); }, operations, config, recorder);
+}
+
+template <typename Trace>
+qint64 replayChainedVariant(const QString &index, const QString &hash, const std::vector<LoggedOperation> &operations,
+                            const ReplayConfig &config, HashMetricsRecorder &recorder) {
+    if (hash == "wy") return replaySized<BasicHashMap<Trace, ModuloIndex, WyHash>>(operations, config, recorder);
+    if (hash == "xxh3") return replaySized<BasicHashMap<Trace, ModuloIndex, XxHash3>>(operations, config, recorder);
+    if (hash == "fnv1a") return replaySized<BasicHashMap<Trace, ModuloIndex, Fnv1aHash>>(operations, config, recorder);
+    if (index == "pow2") return replaySized<BasicHashMap<Trace, PowerOfTwoIndex>>(operations, config, recorder);
+    if (index == "prime") return replaySized<BasicHashMap<Trace, PrimeIndex>>(operations, config, recorder);
+    if (index == "fastrange") return replaySized<BasicHashMap<Trace, FastRangeIndex>>(operations, config, recorder);
+    return replaySized<BasicHashMap<Trace, ModuloIndex>>(operations, config, recorder);
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName(QStringLiteral("AdvDS_replay"));
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("Replays a HashMap operation log at full speed."));
+    parser.addHelpOption();
+    parser.addPositionalArgument(QStringLiteral("log"), QStringLiteral("Operation log to replay."));
+    const QCommandLineOption engineOption(QStringLiteral("engine"),
+        QStringLiteral("chaining, robinhood, swiss, concurrent or readoptimized."), QStringLiteral("name"), QStringLiteral("chaining"));
+    const QCommandLineOption indexOption(QStringLiteral("index"),
+        QStringLiteral("Chaining bucket index: modulo, pow2, prime or fastrange."), QStringLiteral("name"), QStringLiteral("modulo"));
+    const QCommandLineOption hashOption(QStringLiteral("hash"),
+        QStringLiteral("Chaining hash function: qt, wy, xxh3 or fnv1a."), QStringLiteral("name"), QStringLiteral("qt"));
+    const QCommandLineOption bucketsOption(QStringLiteral("buckets"),
+        QStringLiteral("Initial bucket or slot count (default: taken from the log)."), QStringLiteral("count"));
+    const QCommandLineOption repeatOption(QStringLiteral("repeat"),
+        QStringLiteral("Number of times to replay the log."), QStringLiteral("count"), QStringLiteral("1"));
+    const QCommandLineOption sampleOption(QStringLiteral("sample"),
+        QStringLiteral("Time one operation in this many."), QStringLiteral("count"), QStringLiteral("16"));
+    const QCommandLineOption traceOption(QStringLiteral("trace"), QStringLiteral("Record step traces (chaining only)."));
+    const QCommandLineOption incrementalOption(QStringLiteral("incremental"), QStringLiteral("Rehash incrementally (chaining only)."));
+    const QCommandLineOption bloomOption(QStringLiteral("bloom"), QStringLiteral("Enable the Bloom filter (chaining only)."));
+    for (const QCommandLineOption &option : {engineOption, indexOption, hashOption, bucketsOption, repeatOption,
+                                             sampleOption, traceOption, incrementalOption, bloomOption}) {
+        parser.addOption(option);
+    }
+    parser.process(app);
+
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+    QString error;
+    if (!verifyHashFunctions(&error)) {
+        err << "Hash self-test failed: " << error << '\n';
+        return 1;
+    }
+    const QStringList arguments = parser.positionalArguments();
+    if (arguments.size() != 1) {
+        err << "Expected exactly one operation log.\n";
+        return 2;
+    }
+
+    ReplayConfig config;
+    config.repeat = std::max(1, parser.value(repeatOption).toInt());
+    config.sampleEvery = std::max(1, parser.value(sampleOption).toInt());
+    config.incremental = parser.isSet(incrementalOption);
+    config.bloom = parser.isSet(bloomOption);
+    const QString engine = parser.value(engineOption);
+    const QString index = parser.value(indexOption);
+    const QString hash = parser.value(hashOption);
+    // replayChainedVariant() falls back to modulo and qHash, so a misspelt
+    // name would silently measure the default configuration.
+    if (!QStringList{"modulo", "pow2", "prime", "fastrange"}.contains(index)) {
+        err << "Unknown index: " << index << '\n';
+        return 2;
+    }
+    if (!QStringList{"qt", "wy", "xxh3", "fnv1a"}.contains(hash)) {
+        err << "Unknown hash: " << hash << '\n';
+        return 2;
+    }
+    if (index != "modulo" && hash != "qt") {
+        // Only these combinations are instantiated (see hashmap.h).
+        err << "--index and --hash cannot both be changed.\n";
+        return 2;
+    }
+
+    OperationLog log;
+    if (!log.load(arguments.first(), &error)) {
+        err << error << '\n';
+        return 1;
+    }
+    if (parser.isSet(bucketsOption)) {
+        config.buckets = std::max(1, parser.value(bucketsOption).toInt());
+    } else if (log.initialBucketCount() > 0) {
+        config.buckets = log.initialBucketCount();
+    }
+    const std::vector<LoggedOperation> operations = log.operations();
+
+    HashMetricsRecorder recorder(config.sampleEvery);
+    qint64 nanos = 0;
+    if (engine == "chaining") {
+        nanos = parser.isSet(traceOption) ? replayChainedVariant<StepTrace>(index, hash, operations, config, recorder)
+                                          : replayChainedVariant<NoTrace>(index, hash, operations, config, recorder);
+    } else if (engine == "robinhood") {
+        nanos = replaySized<FastRobinHoodHashMap>(operations, config, recorder);
+    } else if (engine == "swiss") {
+        nanos = replaySized<FastSwissHashMap>(operations, config, recorder);
+    } else if (engine == "concurrent") {
+        nanos = replayRepeated<ConcurrentHashMap>([] { return std::make_unique<ConcurrentHashMap>(); },
+                                                  operations, config, recorder);
+    } else if (engine == "readoptimized") {
+        nanos = replaySized<ReadOptimizedHashMap>(operations, config, recorder);
+    } else {
+        err << "Unknown engine: " << engine << '\n';
+        return 2;
+    }
+
+    const HashMapMetrics metrics = recorder.snapshot();
+    const quint64 total = static_cast<quint64>(operations.size()) * static_cast<quint64>(config.repeat);
+    out << "Replayed " << total << " operations (" << operations.size() << " x " << config.repeat << ") in "
+        << formatNanos(static_cast<double>(nanos)) << ": "
+        << QString::number(nanos > 0 ? total * 1e9 / nanos : 0.0, 'f', 0) << " ops/s\n";
+    out << "Gets: " << metrics.hits << " hits, " << metrics.misses << " misses\n";
+    out << QStringLiteral("%1%2%3%4%5\n").arg(QStringLiteral("op"), -10).arg(QStringLiteral("count"), 12)
+               .arg(QStringLiteral("p50"), 12).arg(QStringLiteral("p99"), 12).arg(QStringLiteral("p99.9"), 12);
+    for (int op = 0; op < kHashOperationCount; ++op) {
+        const LatencySummary &latency = metrics.latency[op];
+        if (metrics.operations[op] == 0) continue;
+        out << QStringLiteral("%1%2%3%4%5\n")
+                   .arg(QLatin1String(hashOperationName(static_cast<HashOperation>(op))), -10)
+                   .arg(metrics.operations[op], 12)
+                   .arg(formatNanos(latency.p50Nanos), 12)
+                   .arg(formatNanos(latency.p99Nanos), 12)
+                   .arg(formatNanos(latency.p999Nanos), 12);
+    }
+    return 0;
+}
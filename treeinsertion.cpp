@@ -9,7 +9,9 @@
 
 TreeInsertion::TreeInsertion(QWidget *parent)
     : QWidget(parent)
-    , root(nullptr)
+    , highlightedNode(kNoTreeNode)
+    , newNode(kNoTreeNode)
+    , hiddenNode(kNoTreeNode)
     , currentTraversalStep(0)
     , isAnimating(false)
 {
@@ -24,7 +26,6 @@ TreeInsertion::TreeInsertion(QWidget *parent)
 
 TreeInsertion::~TreeInsertion()
 {
-    clearTree(root);
 }
 
 void TreeInsertion::setupUI()
@@ -217,164 +218,87 @@ void TreeInsertion::onClearClicked()
         return;
     }
 
-    clearTree(root);
-    root = nullptr;
+    tree.clear();
+    highlightedNode = kNoTreeNode;
+    newNode = kNoTreeNode;
+    hiddenNode = kNoTreeNode;
     statusLabel->setText("Tree cleared! Start by inserting a value.");
     update();
 }
 
-void TreeInsertion::insertNode(int value)
+void TreeInsertion::setAnimating(bool animating)
 {
-    TreeNode *newNode = new TreeNode(value);
-    newNode->isNewNode = true;
-
-    if (!root) {
-        root = newNode;
-        statusLabel->setText(QString("Inserted %1 as root node").arg(value));
-        return;
-    }
-
-    TreeNode *current = root;
-    TreeNode *parent = nullptr;
-
-    while (current) {
-        parent = current;
-        if (value < current->value) {
-            current = current->left;
-        } else if (value > current->value) {
-            current = current->right;
-        } else {
-            delete newNode;
-            statusLabel->setText(QString("Value %1 already exists in tree!").arg(value));
-            return;
-        }
-    }
-
-    if (value < parent->value) {
-        parent->left = newNode;
-        statusLabel->setText(QString("Inserted %1 as left child of %2").arg(value).arg(parent->value));
-    } else {
-        parent->right = newNode;
-        statusLabel->setText(QString("Inserted %1 as right child of %2").arg(value).arg(parent->value));
-    }
+    isAnimating = animating;
+    insertButton->setEnabled(!animating);
+    clearButton->setEnabled(!animating);
 }
 
 void TreeInsertion::animateInsertion(int value)
 {
-    isAnimating = true;
-    insertButton->setEnabled(false);
-    clearButton->setEnabled(false);
-
-    // Build traversal path
-    traversalPath.clear();
-
-    if (!root) {
-        insertNode(value);
-        isAnimating = false;
-        insertButton->setEnabled(true);
-        clearButton->setEnabled(true);
-        update();
+    highlightedNode = kNoTreeNode;
+    newNode = kNoTreeNode;
+
+    // The model inserts at once; the view then plays back its steps with
+    // the new node hidden until the last comparison has been shown
+    if (!tree.insert(value)) {
+        QMessageBox::warning(this, "Duplicate Value",
+                             QString("Value %1 already exists in tree!").arg(value));
         return;
     }
 
-    TreeNode *current = root;
-    while (current) {
-        traversalPath.append(current);
-        if (value < current->value) {
-            if (!current->left) {
-                break;
-            }
-            current = current->left;
-        } else if (value > current->value) {
-            if (!current->right) {
-                break;
-            }
-            current = current->right;
-        } else {
-            // Duplicate value
-            QMessageBox::warning(this, "Duplicate Value",
-                                 QString("Value %1 already exists in tree!").arg(value));
-            isAnimating = false;
-            insertButton->setEnabled(true);
-            clearButton->setEnabled(true);
-            return;
-        }
+    const TreeStepTrace &steps = tree.lastSteps();
+    if (steps.size() == 1) {
+        newNode = tree.find(value);
+        statusLabel->setText(steps.format(0));
+        update();
+        return;
     }
 
+    setAnimating(true);
+    hiddenNode = tree.find(value);
     currentTraversalStep = 0;
 
-    QTimer::singleShot(0, this, [this, value]() {
-        animateTraversal(root, value, 0);
+    QTimer::singleShot(0, this, [this]() {
+        animateTraversal(0);
     });
 }
 
-void TreeInsertion::animateTraversal(TreeNode *node, int value, int step)
+void TreeInsertion::animateTraversal(int step)
 {
-    if (step >= traversalPath.size()) {
-        // Animation complete, insert the node
-        insertNode(value);
-        resetHighlights(root);
-        isAnimating = false;
-        insertButton->setEnabled(true);
-        clearButton->setEnabled(true);
+    const TreeStepTrace &steps = tree.lastSteps();
+    const TreeStep &current = steps.at(step);
+    statusLabel->setText(steps.format(step));
+
+    if (current.op != TreeStepOp::Compare) {
+        // Animation complete, reveal the node
+        highlightedNode = kNoTreeNode;
+        newNode = hiddenNode;
+        hiddenNode = kNoTreeNode;
+        setAnimating(false);
         update();
         return;
     }
 
-    resetHighlights(root);
-    traversalPath[step]->isHighlighted = true;
-
-    if (step == 0) {
-        statusLabel->setText(QString("Comparing %1 with root %2").arg(value).arg(traversalPath[step]->value));
-    } else {
-        statusLabel->setText(QString("Comparing %1 with %2").arg(value).arg(traversalPath[step]->value));
-    }
-
+    currentTraversalStep = step;
+    highlightedNode = tree.find(current.other);
     update();
 
-    QTimer::singleShot(800, this, [this, node, value, step]() {
-        animateTraversal(node, value, step + 1);
+    QTimer::singleShot(800, this, [this, step]() {
+        animateTraversal(step + 1);
     });
 }
 
-void TreeInsertion::calculateNodePositions(TreeNode *node, int x, int y, int horizontalSpacing)
+void TreeInsertion::calculateNodePositions(TreeNodeId node, int x, int y, int horizontalSpacing)
 {
-    if (!node) return;
+    if (node == kNoTreeNode || node == hiddenNode) return;
 
-    node->x = x;
-    node->y = y;
+    nodePositions[node] = QPoint(x, y);
 
     int nextSpacing = horizontalSpacing / 2;
+    const TreeNode &current = tree.node(node);
 
-    if (node->left) {
-        calculateNodePositions(node->left, x - horizontalSpacing, y + LEVEL_HEIGHT, nextSpacing);
-    }
-    if (node->right) {
-        calculateNodePositions(node->right, x + horizontalSpacing, y + LEVEL_HEIGHT, nextSpacing);
-    }
-}
-
-void TreeInsertion::resetHighlights(TreeNode *node)
-{
-    if (!node) return;
-    node->isHighlighted = false;
-    node->isNewNode = false;
-    resetHighlights(node->left);
-    resetHighlights(node->right);
-}
-
-void TreeInsertion::clearTree(TreeNode *node)
-{
-    if (!node) return;
-    clearTree(node->left);
-    clearTree(node->right);
-    delete node;
-}
-
-int TreeInsertion::getTreeHeight(TreeNode *node)
-{
-    if (!node) return 0;
-    return 1 + std::max(getTreeHeight(node->left), getTreeHeight(node->right));
+    calculateNodePositions(current.left, x - horizontalSpacing, y + LEVEL_HEIGHT, nextSpacing);
+    calculateNodePositions(current.right, x + horizontalSpacing, y + LEVEL_HEIGHT, nextSpacing);
 }
 
 void TreeInsertion::paintEvent(QPaintEvent *event)
@@ -400,43 +324,48 @@ void TreeInsertion::paintEvent(QPaintEvent *event)
     painter.drawRoundedRect(canvasRect, 16, 16);
 
     // Draw tree if exists - position relative to canvas
-    if (root) {
+    if (!tree.isEmpty()) {
         int canvasWidth = canvasRect.width();
         int canvasCenterX = canvasRect.x() + canvasWidth / 2;
         int treeStartY = canvasRect.y() + 50;
 
-        calculateNodePositions(root, canvasCenterX, treeStartY, canvasWidth / 4);
-        drawTree(painter, root);
+        nodePositions.resize(tree.nodeCount());
+        calculateNodePositions(tree.root(), canvasCenterX, treeStartY, canvasWidth / 4);
+        drawTree(painter, tree.root());
     }
 }
 
-void TreeInsertion::drawTree(QPainter &painter, TreeNode *node)
+void TreeInsertion::drawTree(QPainter &painter, TreeNodeId node)
 {
-    if (!node) return;
+    if (node == kNoTreeNode || node == hiddenNode) return;
+
+    const TreeNode &current = tree.node(node);
 
     // Draw edges first
-    if (node->left) {
-        drawEdge(painter, node->x, node->y, node->left->x, node->left->y);
-        drawTree(painter, node->left);
+    if (current.left != kNoTreeNode && current.left != hiddenNode) {
+        drawEdge(painter, nodePositions[node], nodePositions[current.left]);
+        drawTree(painter, current.left);
     }
-    if (node->right) {
-        drawEdge(painter, node->x, node->y, node->right->x, node->right->y);
-        drawTree(painter, node->right);
+    if (current.right != kNoTreeNode && current.right != hiddenNode) {
+        drawEdge(painter, nodePositions[node], nodePositions[current.right]);
+        drawTree(painter, current.right);
     }
 
     // Draw node on top
     drawNode(painter, node);
 }
 
-void TreeInsertion::drawNode(QPainter &painter, TreeNode *node)
+void TreeInsertion::drawNode(QPainter &painter, TreeNodeId node)
 {
-    if (!node) return;
+    if (node == kNoTreeNode) return;
+
+    const QPoint center = nodePositions[node];
 
     // Node circle
-    if (node->isHighlighted) {
+    if (node == highlightedNode) {
         painter.setPen(QPen(QColor(255, 165, 0), 4));
         painter.setBrush(QColor(255, 200, 100));
-    } else if (node->isNewNode) {
+    } else if (node == newNode) {
         painter.setPen(QPen(QColor(50, 205, 50), 4));
         painter.setBrush(QColor(144, 238, 144));
     } else {
@@ -444,19 +373,19 @@ void TreeInsertion::drawNode(QPainter &painter, TreeNode *node)
         painter.setBrush(QColor(200, 180, 255));
     }
 
-    painter.drawEllipse(QPoint(node->x, node->y), NODE_RADIUS, NODE_RADIUS);
+    painter.drawEllipse(center, NODE_RADIUS, NODE_RADIUS);
 
     // Node value
     painter.setPen(Qt::black);
     QFont font("Segoe UI", 14, QFont::Bold);
     painter.setFont(font);
-    painter.drawText(QRect(node->x - NODE_RADIUS, node->y - NODE_RADIUS,
+    painter.drawText(QRect(center.x() - NODE_RADIUS, center.y() - NODE_RADIUS,
                            NODE_RADIUS * 2, NODE_RADIUS * 2),
-                     Qt::AlignCenter, QString::number(node->value));
+                     Qt::AlignCenter, QString::number(tree.node(node).value));
 }
 
-void TreeInsertion::drawEdge(QPainter &painter, int x1, int y1, int x2, int y2)
+void TreeInsertion::drawEdge(QPainter &painter, QPoint from, QPoint to)
 {
     painter.setPen(QPen(QColor(123, 79, 255), 2));
-    painter.drawLine(x1, y1 + NODE_RADIUS, x2, y2 - NODE_RADIUS);
+    painter.drawLine(from.x(), from.y() + NODE_RADIUS, to.x(), to.y() - NODE_RADIUS);
 }
@@ -12,20 +12,9 @@
 #include <QSequentialAnimationGroup>
 #include <QTimer>
 #include <QVector>
+#include <QPoint>
 #include <QGraphicsOpacityEffect>
-
-// Tree Node structure
-struct TreeNode {
-    int value;
-    TreeNode *left;
-    TreeNode *right;
-    int x, y;  // Position for drawing
-    bool isHighlighted;
-    bool isNewNode;
-
-    TreeNode(int val) : value(val), left(nullptr), right(nullptr),
-        x(0), y(0), isHighlighted(false), isNewNode(false) {}
-};
+#include "bstree.h"
 
 class TreeInsertion : public QWidget
 {
@@ -48,16 +37,13 @@ private slots:
 
 private:
     void setupUI();
-    void insertNode(int value);
     void animateInsertion(int value);
-    void calculateNodePositions(TreeNode *node, int x, int y, int horizontalSpacing);
-    void drawTree(QPainter &painter, TreeNode *node);
-    void drawNode(QPainter &painter, TreeNode *node);
-    void drawEdge(QPainter &painter, int x1, int y1, int x2, int y2);
-    void clearTree(TreeNode *node);
-    int getTreeHeight(TreeNode *node);
-    void resetHighlights(TreeNode *node);
-    void animateTraversal(TreeNode *node, int value, int step);
+    void calculateNodePositions(TreeNodeId node, int x, int y, int horizontalSpacing);
+    void drawTree(QPainter &painter, TreeNodeId node);
+    void drawNode(QPainter &painter, TreeNodeId node);
+    void drawEdge(QPainter &painter, QPoint from, QPoint to);
+    void animateTraversal(int step);
+    void setAnimating(bool animating);
 
     // UI Components
     QPushButton *backButton;
@@ -69,12 +55,16 @@ private:
     QLabel *statusLabel;
     QWidget *canvasWidget;
 
-    // Tree data
-    TreeNode *root;
+    // Tree model; everything below it is view state. Layout is kept out of
+    // the model's nodes, in an array indexed by node id.
+    BinarySearchTree tree;
+    QVector<QPoint> nodePositions;
+    TreeNodeId highlightedNode;
+    TreeNodeId newNode;
+    TreeNodeId hiddenNode; // inserted, but not shown until its animation ends
 
     // Animation
     QTimer *animationTimer;
-    QVector<TreeNode*> traversalPath;
     int currentTraversalStep;
     bool isAnimating;
 